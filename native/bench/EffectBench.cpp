@@ -0,0 +1,334 @@
+// EffectBench.cpp (native effect benchmark)
+
+#ifndef PIO_UNIT_TESTING
+
+#include "EffectBench.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "IO/LED/LEDStrip.h"
+#include "IO/LED/Effects/BrakeLightEffect.h"
+#include "IO/LED/Effects/IndicatorEffect.h"
+#include "IO/LED/Effects/ReverseLightEffect.h"
+#include "IO/LED/Effects/RGBEffect.h"
+#include "IO/LED/Effects/NightRiderEffect.h"
+#include "IO/LED/Effects/TaillightEffect.h"
+#include "IO/LED/Effects/HeadlightEffect.h"
+#include "IO/LED/Effects/PoliceEffect.h"
+#include "IO/LED/Effects/PulseWaveEffect.h"
+#include "IO/LED/Effects/AuroraEffect.h"
+#include "IO/LED/Effects/SolidColorEffect.h"
+#include "IO/LED/Effects/ColorFadeEffect.h"
+#include "IO/LED/Effects/CommitEffect.h"
+#include "IO/LED/Effects/ServiceLightsEffect.h"
+
+// Every heap allocation in the program goes through here while the bench
+// is linked in, so per-frame allocations show up as a count. GCC cannot see
+// that these pair malloc with free and warns at inlined call sites.
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+static std::atomic<uint64_t> allocationCount(0);
+
+void *operator new(std::size_t size)
+{
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+static const uint32_t FRAME_PERIOD_US = 10000;
+static const uint32_t WARMUP_FRAMES = 100;
+
+static const uint16_t segmentLengths[] = {16, 32, 64, 128, 256, 512, 1024};
+
+enum class BenchPath
+{
+  MAIN,      // effect on the strip's main segment
+  FLIPPED,   // strip and main segment flipped, as with headlightFlipped
+  MIRRORED,  // two half segments, the right one flipped
+  SYMMETRIC, // main segment mirrored around its centre LED
+};
+
+static const char *pathName(BenchPath path)
+{
+  switch (path)
+  {
+  case BenchPath::MAIN:
+    return "main";
+  case BenchPath::FLIPPED:
+    return "flipped";
+  case BenchPath::MIRRORED:
+    return "mirrored";
+  case BenchPath::SYMMETRIC:
+    return "symmetric";
+  }
+  return "?";
+}
+
+struct BenchEffect
+{
+  const char *name;
+  // Creates the effect in the state it is benchmarked in
+  std::function<LEDEffect *()> create;
+};
+
+// Steady state modes, the ones that run for minutes on a car
+static std::vector<BenchEffect> benchEffects()
+{
+  return {
+      {"Taillight", []()
+       {
+         TaillightEffect *effect = new TaillightEffect(4, false);
+         effect->setDim();
+         return effect;
+       }},
+      {"Headlight", []()
+       {
+         HeadlightEffect *effect = new HeadlightEffect(4, false);
+         effect->setCarOn();
+         return effect;
+       }},
+      {"Indicator", []()
+       {
+         IndicatorEffect *effect = new IndicatorEffect(IndicatorEffect::LEFT, 10, true);
+         effect->setActive(true);
+         return effect;
+       }},
+      {"BrakeLight", []()
+       {
+         BrakeLightEffect *effect = new BrakeLightEffect(9, true);
+         effect->setActive(true);
+         return effect;
+       }},
+      {"ReverseLight", []()
+       {
+         ReverseLightEffect *effect = new ReverseLightEffect(8, true);
+         effect->setActive(true);
+         return effect;
+       }},
+      {"Police", []()
+       {
+         PoliceEffect *effect = new PoliceEffect(4, false);
+         effect->setActive(true);
+         return effect;
+       }},
+      {"ServiceLights", []()
+       {
+         ServiceLightsEffect *effect = new ServiceLightsEffect(5, false);
+         effect->setActive(true);
+         return effect;
+       }},
+      {"Commit", []()
+       {
+         CommitEffect *effect = new CommitEffect(5, false);
+         effect->setActive(true);
+         return effect;
+       }},
+      {"NightRider", []()
+       {
+         NightRiderEffect *effect = new NightRiderEffect(5, false);
+         effect->setActive(true);
+         return effect;
+       }},
+      {"RGB", []()
+       {
+         RGBEffect *effect = new RGBEffect(5, false);
+         effect->setActive(true);
+         return effect;
+       }},
+      {"Aurora", []()
+       {
+         AuroraEffect *effect = new AuroraEffect(5, false);
+         effect->setActive(true);
+         return effect;
+       }},
+      {"PulseWave", []()
+       {
+         PulseWaveEffect *effect = new PulseWaveEffect(5, false);
+         effect->setActive(true);
+         return effect;
+       }},
+      {"ColorFade", []()
+       {
+         ColorFadeEffect *effect = new ColorFadeEffect(5, false);
+         effect->setActive(true);
+         return effect;
+       }},
+      {"SolidColor", []()
+       {
+         SolidColorEffect *effect = new SolidColorEffect(5, false);
+         effect->setActive(true);
+         return effect;
+       }},
+  };
+}
+
+// CPU cycles where the host has a cycle counter, nanoseconds otherwise
+static inline uint64_t benchCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+struct BenchResult
+{
+  double updateNs;      // per frame
+  double renderNs;      // per frame
+  double renderCycles;  // per LED
+  double allocsPerFrame;
+};
+
+static LEDStrip *createStrip(BenchPath path, uint16_t numLEDs, LEDEffect *effect)
+{
+  LEDStrip *strip = new LEDStrip("Bench", numLEDs, 1);
+  strip->setActive(true);
+
+  switch (path)
+  {
+  case BenchPath::MAIN:
+    strip->addEffect(effect);
+    break;
+
+  case BenchPath::FLIPPED:
+    strip->setFliped(true);
+    strip->getMainSegment()->fliped = true;
+    strip->addEffect(effect);
+    break;
+
+  case BenchPath::MIRRORED:
+  {
+    uint16_t half = numLEDs / 2;
+    LEDSegment *left = new LEDSegment(strip, "Bench-Left", 0, half);
+    LEDSegment *right = new LEDSegment(strip, "Bench-Right", half, numLEDs - half);
+    right->fliped = true;
+    left->addEffect(effect);
+    right->addEffect(effect);
+  }
+  break;
+
+  case BenchPath::SYMMETRIC:
+    strip->getMainSegment()->setSymmetry(SegmentSymmetry::MIRROR_CENTER);
+    strip->addEffect(effect);
+    break;
+  }
+
+  return strip;
+}
+
+static BenchResult runOne(const BenchEffect &benchEffect, BenchPath path, uint16_t numLEDs, uint32_t frames)
+{
+  nativeSetMicros(1000000);
+  LEDEffect::setFrameClock(nullptr);
+  randomSeed(12345);
+
+  LEDEffect *effect = benchEffect.create();
+  LEDStrip *strip = createStrip(path, numLEDs, effect);
+
+  for (uint32_t i = 0; i < WARMUP_FRAMES; i++)
+  {
+    nativeAdvanceMicros(FRAME_PERIOD_US);
+    LEDEffect::updateAll();
+    strip->renderEffects();
+    strip->draw();
+  }
+
+  using clock = std::chrono::steady_clock;
+  clock::duration updateTime(0), renderTime(0);
+  uint64_t renderCycles = 0;
+  uint64_t allocationsBefore = allocationCount.load();
+
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    nativeAdvanceMicros(FRAME_PERIOD_US);
+
+    auto start = clock::now();
+    LEDEffect::updateAll();
+    auto updated = clock::now();
+    uint64_t cyclesStart = benchCycles();
+    strip->renderEffects();
+    uint64_t cyclesEnd = benchCycles();
+    auto rendered = clock::now();
+
+    updateTime += updated - start;
+    renderTime += rendered - updated;
+    renderCycles += cyclesEnd - cyclesStart;
+
+    // Keeps the frame queue moving like LEDStripTask does, untimed
+    strip->draw();
+  }
+
+  BenchResult result;
+  result.updateNs = std::chrono::duration<double, std::nano>(updateTime).count() / frames;
+  result.renderNs = std::chrono::duration<double, std::nano>(renderTime).count() / frames;
+  result.renderCycles = (double)renderCycles / frames / numLEDs;
+  result.allocsPerFrame = (double)(allocationCount.load() - allocationsBefore) / frames;
+
+  delete effect;
+  delete strip;
+  return result;
+}
+
+int runEffectBench(uint32_t frames, bool csv, const String &filter)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  const char *cycleUnit = "cycles";
+#else
+  const char *cycleUnit = "ns"; // no cycle counter, same column in ns
+#endif
+
+  if (csv)
+    printf("effect,path,leds,update_ns_per_frame,render_ns_per_frame,render_%s_per_led,allocs_per_frame\n", cycleUnit);
+  else
+    printf("%-14s %-9s %6s %12s %12s %12s %10s\n", "effect", "path", "leds", "update ns", "render ns",
+           cycleUnit[0] == 'c' ? "cycles/LED" : "ns/LED", "allocs/f");
+
+  const BenchPath paths[] = {BenchPath::MAIN, BenchPath::FLIPPED, BenchPath::MIRRORED, BenchPath::SYMMETRIC};
+
+  for (const BenchEffect &benchEffect : benchEffects())
+  {
+    if (filter.length() > 0 && !strstr(benchEffect.name, filter.c_str()))
+      continue;
+
+    for (BenchPath path : paths)
+    {
+      for (uint16_t numLEDs : segmentLengths)
+      {
+        BenchResult result = runOne(benchEffect, path, numLEDs, frames);
+
+        if (csv)
+          printf("%s,%s,%u,%.1f,%.1f,%.2f,%.3f\n", benchEffect.name, pathName(path), numLEDs,
+                 result.updateNs, result.renderNs, result.renderCycles, result.allocsPerFrame);
+        else
+          printf("%-14s %-9s %6u %12.1f %12.1f %12.2f %10.3f\n", benchEffect.name, pathName(path), numLEDs,
+                 result.updateNs, result.renderNs, result.renderCycles, result.allocsPerFrame);
+      }
+    }
+
+    if (!csv)
+      printf("\n");
+  }
+
+  return 0;
+}
+
+#endif
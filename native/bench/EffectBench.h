@@ -0,0 +1,14 @@
+// EffectBench.h (native effect benchmark)
+//
+// Times update() and render() of every LEDEffect on its own, for segment
+// lengths 16 to 1024, on a plain main segment, a flipped strip (the
+// headlight/taillight orientation option) and a strip mirrored as two
+// halves with the right half flipped. Also counts heap allocations per frame.
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// filter: only effects whose name contains it (empty for all)
+int runEffectBench(uint32_t frames, bool csv, const String &filter);
@@ -0,0 +1,400 @@
+// main.cpp (native frame benchmark)
+//
+// Builds the same strip/effect layout as Application::setupEffects() with
+// headlight, taillight and underglow strips of equal length, then times
+// LEDStripManager::updateEffects() + draw() for a set of scenes.
+//
+//   .pio/build/native/program [--frames N] [--csv] [--hsv] [--effects [NAME]]
+//
+// --hsv instead checks the integer HSV conversions against Color::hsv2rgb()
+// and times all three.
+// --effects instead times each effect on its own (see EffectBench.h),
+// optionally only the ones whose name contains NAME.
+
+#ifndef PIO_UNIT_TESTING
+
+#include <Arduino.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#include "IO/LED/LEDStripManager.h"
+#include "IO/LED/LEDLayout.h"
+#include "IO/LED/Effects/BrakeLightEffect.h"
+#include "IO/LED/Effects/IndicatorEffect.h"
+#include "IO/LED/Effects/ReverseLightEffect.h"
+#include "IO/LED/Effects/RGBEffect.h"
+#include "IO/LED/Effects/NightRiderEffect.h"
+#include "IO/LED/Effects/TaillightEffect.h"
+#include "IO/LED/Effects/HeadlightEffect.h"
+#include "IO/LED/Effects/PoliceEffect.h"
+#include "IO/LED/Effects/PulseWaveEffect.h"
+#include "IO/LED/Effects/AuroraEffect.h"
+#include "IO/LED/Effects/SolidColorEffect.h"
+#include "IO/LED/Effects/ColorFadeEffect.h"
+#include "IO/LED/Effects/CommitEffect.h"
+#include "IO/LED/Effects/ServiceLightsEffect.h"
+
+#include "EffectBench.h"
+
+// Virtual time between frames (the app updates effects at 100 Hz)
+static const uint32_t FRAME_PERIOD_US = 10000;
+static const uint32_t WARMUP_FRAMES = 100;
+
+static const uint16_t stripLengths[] = {50, 100, 200, 300, 500, 1000};
+
+struct BenchEffects
+{
+  IndicatorEffect *leftIndicator;
+  IndicatorEffect *rightIndicator;
+  HeadlightEffect *headlight;
+  TaillightEffect *taillight;
+  BrakeLightEffect *brake;
+  ReverseLightEffect *reverseLight;
+  RGBEffect *rgb;
+  NightRiderEffect *nightrider;
+  PoliceEffect *police;
+  PulseWaveEffect *pulseWave;
+  AuroraEffect *aurora;
+  SolidColorEffect *solidColor;
+  ColorFadeEffect *colorFade;
+  CommitEffect *commit;
+  ServiceLightsEffect *serviceLights;
+};
+
+struct Scene
+{
+  const char *name;
+  std::function<void(BenchEffects &)> activate;
+};
+
+// Same priorities as Application::setupEffects()
+static BenchEffects createEffects()
+{
+  BenchEffects fx;
+  fx.leftIndicator = new IndicatorEffect(IndicatorEffect::LEFT, 10, true);
+  fx.rightIndicator = new IndicatorEffect(IndicatorEffect::RIGHT, 10, true);
+  fx.leftIndicator->setOtherIndicator(fx.rightIndicator);
+  fx.rightIndicator->setOtherIndicator(fx.leftIndicator);
+
+  fx.brake = new BrakeLightEffect(9, true);
+  fx.reverseLight = new ReverseLightEffect(8, true);
+
+  fx.headlight = new HeadlightEffect(4, false);
+  fx.taillight = new TaillightEffect(4, false);
+
+  fx.rgb = new RGBEffect(5, false);
+  fx.nightrider = new NightRiderEffect(5, false);
+  fx.pulseWave = new PulseWaveEffect(5, false);
+  fx.aurora = new AuroraEffect(5, false);
+  fx.solidColor = new SolidColorEffect(5, false);
+  fx.colorFade = new ColorFadeEffect(5, false);
+  fx.police = new PoliceEffect(4, false);
+  fx.commit = new CommitEffect(5, false);
+  fx.serviceLights = new ServiceLightsEffect(5, false);
+  return fx;
+}
+
+// Strips and effect attachment mirror Application::begin() / setupEffects()
+static LEDStripManager *createCar(BenchEffects &fx, uint16_t numLEDs)
+{
+  LEDStripManager *manager = new LEDStripManager();
+
+  LEDStripConfig headlights(LEDStripType::HEADLIGHT, "Headlights", numLEDs, 1);
+  ledLayout.place(headlights.strip->getMainSegment(), layoutPoint(-0.8f, 1.0f), layoutPoint(0.8f, 1.0f));
+  headlights.strip->getMainSegment()->setSymmetry(SegmentSymmetry::MIRROR);
+  manager->addLEDStrip(headlights);
+  headlights.strip->setActive(true);
+
+  LEDStripConfig taillights(LEDStripType::TAILLIGHT, "Taillights", numLEDs, 2);
+  ledLayout.place(taillights.strip->getMainSegment(), layoutPoint(-0.8f, -1.0f), layoutPoint(0.8f, -1.0f));
+  taillights.strip->getMainSegment()->setSymmetry(SegmentSymmetry::MIRROR_CENTER);
+  manager->addLEDStrip(taillights);
+  taillights.strip->setActive(true);
+
+  LEDStripConfig underglow(LEDStripType::UNDERGLOW, "Underglow", numLEDs, 3);
+  uint16_t sideLEDs = numLEDs * 102 / 300;
+  uint16_t frontLEDs = numLEDs - sideLEDs * 2;
+  new LEDSegment(underglow.strip, "Underglow-Left", 0, sideLEDs);
+  new LEDSegment(underglow.strip, "Underglow-Front", sideLEDs, frontLEDs);
+  new LEDSegment(underglow.strip, "Underglow-Right", sideLEDs + frontLEDs, sideLEDs);
+  LEDSegment *underglowMain = underglow.strip->getMainSegment();
+  ledLayout.place(underglowMain, 0, sideLEDs, layoutPoint(-1.0f, -0.9f), layoutPoint(-1.0f, 0.9f));
+  ledLayout.place(underglowMain, sideLEDs, frontLEDs, layoutPoint(-0.9f, 1.0f), layoutPoint(0.9f, 1.0f));
+  ledLayout.place(underglowMain, sideLEDs + frontLEDs, sideLEDs, layoutPoint(1.0f, 0.9f), layoutPoint(1.0f, -0.9f));
+  underglowMain->setSymmetry(SegmentSymmetry::MIRROR_CENTER);
+  manager->addLEDStrip(underglow);
+  underglow.strip->setActive(true);
+
+  LEDStrip *headlightStrip = headlights.strip;
+  headlightStrip->addEffect(fx.leftIndicator);
+  headlightStrip->addEffect(fx.rightIndicator);
+  headlightStrip->addEffect(fx.headlight);
+  headlightStrip->addEffect(fx.rgb);
+  headlightStrip->addEffect(fx.nightrider);
+  headlightStrip->addEffect(fx.police);
+  headlightStrip->addEffect(fx.pulseWave);
+  headlightStrip->addEffect(fx.aurora);
+  headlightStrip->addEffect(fx.solidColor);
+  headlightStrip->addEffect(fx.colorFade);
+  headlightStrip->addEffect(fx.commit);
+  headlightStrip->addEffect(fx.serviceLights);
+
+  LEDStrip *taillightStrip = taillights.strip;
+  taillightStrip->addEffect(fx.leftIndicator);
+  taillightStrip->addEffect(fx.rightIndicator);
+  taillightStrip->addEffect(fx.taillight);
+  taillightStrip->addEffect(fx.brake);
+  taillightStrip->addEffect(fx.reverseLight);
+  taillightStrip->addEffect(fx.rgb);
+  taillightStrip->addEffect(fx.nightrider);
+  taillightStrip->addEffect(fx.police);
+  taillightStrip->addEffect(fx.aurora);
+  taillightStrip->addEffect(fx.solidColor);
+  taillightStrip->addEffect(fx.colorFade);
+  taillightStrip->addEffect(fx.commit);
+  taillightStrip->addEffect(fx.serviceLights);
+
+  LEDStrip *underglowStrip = underglow.strip;
+  underglowStrip->addEffect(fx.rgb);
+  underglowStrip->addEffect(fx.nightrider);
+  underglowStrip->addEffect(fx.police);
+  underglowStrip->addEffect(fx.pulseWave);
+  underglowStrip->addEffect(fx.aurora);
+  underglowStrip->addEffect(fx.solidColor);
+  underglowStrip->addEffect(fx.colorFade);
+  underglowStrip->addEffect(fx.commit);
+  underglowStrip->addEffect(fx.serviceLights);
+
+  ledLayout.build();
+  return manager;
+}
+
+static std::vector<Scene> createScenes()
+{
+  return {
+      {"idle", [](BenchEffects &fx) {}},
+      {"car-on", [](BenchEffects &fx)
+       {
+         fx.headlight->setCarOn();
+         fx.taillight->setDim();
+       }},
+      {"car-on+indicator", [](BenchEffects &fx)
+       {
+         fx.headlight->setCarOn();
+         fx.taillight->setDim();
+         fx.leftIndicator->setActive(true);
+       }},
+      {"brake", [](BenchEffects &fx)
+       {
+         fx.taillight->setDim();
+         fx.brake->setActive(true);
+       }},
+      {"rgb", [](BenchEffects &fx)
+       { fx.rgb->setActive(true); }},
+      {"nightrider", [](BenchEffects &fx)
+       { fx.nightrider->setActive(true); }},
+      {"police", [](BenchEffects &fx)
+       { fx.police->setActive(true); }},
+      {"pulsewave", [](BenchEffects &fx)
+       { fx.pulseWave->setActive(true); }},
+      {"aurora", [](BenchEffects &fx)
+       { fx.aurora->setActive(true); }},
+      {"solid", [](BenchEffects &fx)
+       { fx.solidColor->setActive(true); }},
+      {"colorfade", [](BenchEffects &fx)
+       { fx.colorFade->setActive(true); }},
+      {"commit", [](BenchEffects &fx)
+       { fx.commit->setActive(true); }},
+      {"service", [](BenchEffects &fx)
+       { fx.serviceLights->setActive(true); }},
+  };
+}
+
+struct SceneResult
+{
+  double usPerFrame;
+  double sharedPerFrame; // bottom layers copied from another strip instead of rendered
+};
+
+static const LEDStripType carStrips[] = {LEDStripType::HEADLIGHT, LEDStripType::TAILLIGHT, LEDStripType::UNDERGLOW};
+
+static uint32_t sharedRenders(LEDStripManager *manager)
+{
+  uint32_t shared = 0;
+  for (LEDStripType type : carStrips)
+    shared += manager->getStrip(type)->getSharedRenders();
+  return shared;
+}
+
+static SceneResult runScene(LEDStripManager *manager, BenchEffects &fx, const Scene &scene, uint32_t frames)
+{
+  LEDEffect::disableAllEffects();
+  nativeAdvanceMicros(FRAME_PERIOD_US);
+  scene.activate(fx);
+
+  for (uint32_t i = 0; i < WARMUP_FRAMES; i++)
+  {
+    nativeAdvanceMicros(FRAME_PERIOD_US);
+    manager->updateEffects();
+    manager->draw();
+  }
+
+  uint32_t sharedBefore = sharedRenders(manager);
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    nativeAdvanceMicros(FRAME_PERIOD_US);
+    manager->updateEffects();
+    manager->draw();
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  double totalUs = std::chrono::duration<double, std::micro>(end - start).count();
+  return SceneResult{totalUs / frames, (double)(sharedRenders(manager) - sharedBefore) / frames};
+}
+
+// Every hue16 / sat / val combination on a coarse grid against the float version
+static int runHsvCheck()
+{
+  uint32_t checked = 0, exact = 0;
+  int maxError = 0;
+
+  for (uint32_t hue = 0; hue < 65536; hue += 7)
+  {
+    for (uint16_t sat = 0; sat < 256; sat += 15)
+    {
+      for (uint16_t val = 0; val < 256; val += 15)
+      {
+        Color ref = Color::hsv2rgb(hue * (360.0f / 65536.0f), sat / 255.0f, val / 255.0f);
+        Color fixed = Color::hsv2rgb16(hue, sat, val);
+
+        int error = std::max({abs(ref.r - fixed.r), abs(ref.g - fixed.g), abs(ref.b - fixed.b)});
+        maxError = std::max(maxError, error);
+        exact += error == 0;
+        checked++;
+      }
+    }
+  }
+
+  // The span must be the per-pixel conversion, including across the wrap
+  const uint16_t spanLength = 300;
+  Color span[spanLength];
+  uint32_t spanStart = Color::hue32(300.0f);
+  int32_t spanStep = Color::hue32(0.4f);
+  Color::hsv2rgbSpan(span, spanLength, spanStart, spanStep, 200, 180);
+  uint32_t spanMismatches = 0;
+  for (uint16_t i = 0; i < spanLength; i++)
+    spanMismatches += span[i] != Color::hsv2rgb16((spanStart + i * spanStep) >> 16, 200, 180);
+
+  printf("hsv2rgb16 vs hsv2rgb: %u checked, %u exact, max error %d\n", checked, exact, maxError);
+  printf("hsv2rgbSpan vs hsv2rgb16: %u mismatches\n", spanMismatches);
+
+  // Timing: a 300 LED rainbow, as RGBEffect renders it
+  const uint32_t rounds = 20000;
+  uint32_t sink = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < rounds; n++)
+  {
+    for (uint16_t i = 0; i < spanLength; i++)
+      span[i] = Color::hsv2rgb(fmodf(n + i * 0.4f, 360.0f), 1.0f, 1.0f);
+    sink += span[n % spanLength].r;
+  }
+  auto floatEnd = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < rounds; n++)
+  {
+    for (uint16_t i = 0; i < spanLength; i++)
+      span[i] = Color::hsv2rgb16(Color::hue16(n + i * 0.4f), 255, 255);
+    sink += span[n % spanLength].r;
+  }
+  auto fixedEnd = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < rounds; n++)
+  {
+    Color::hsv2rgbSpan(span, spanLength, Color::hue32(n), spanStep, 255, 255);
+    sink += span[n % spanLength].r;
+  }
+  auto spanEnd = std::chrono::steady_clock::now();
+
+  double pixels = (double)rounds * spanLength;
+  printf("%-12s %10s\n", "conversion", "ns/LED");
+  printf("%-12s %10.2f\n", "hsv2rgb", std::chrono::duration<double, std::nano>(floatEnd - start).count() / pixels);
+  printf("%-12s %10.2f\n", "hsv2rgb16", std::chrono::duration<double, std::nano>(fixedEnd - floatEnd).count() / pixels);
+  printf("%-12s %10.2f\n", "hsv2rgbSpan", std::chrono::duration<double, std::nano>(spanEnd - fixedEnd).count() / pixels);
+  printf("(checksum %u)\n", sink);
+
+  return maxError <= 1 && spanMismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t frames = 1000;
+  bool csv = false;
+  bool effects = false;
+  String effectFilter = "";
+
+  for (int i = 1; i < argc; i++)
+  {
+    String arg = argv[i];
+    if (arg == "--frames" && i + 1 < argc)
+      frames = std::max<long>(1, String(argv[++i]).toInt());
+    else if (arg == "--csv")
+      csv = true;
+    else if (arg == "--hsv")
+      return runHsvCheck();
+    else if (arg == "--effects")
+    {
+      effects = true;
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+        effectFilter = argv[++i];
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [--frames N] [--csv] [--hsv] [--effects [NAME]]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  // Strip construction logs are noise here
+  Serial.setOutput(nullptr);
+
+  if (effects)
+    return runEffectBench(frames, csv, effectFilter);
+
+  nativeSetMicros(1000000);
+  BenchEffects fx = createEffects();
+  std::vector<Scene> scenes = createScenes();
+
+  if (csv)
+    printf("scene,leds_per_strip,total_leds,us_per_frame,ns_per_led,shared_per_frame\n");
+  else
+    printf("%-18s %8s %8s %12s %10s %8s\n", "scene", "leds", "total", "us/frame", "ns/LED", "shared");
+
+  for (uint16_t numLEDs : stripLengths)
+  {
+    LEDStripManager *manager = createCar(fx, numLEDs);
+    uint32_t totalLEDs = numLEDs * 3;
+
+    for (const Scene &scene : scenes)
+    {
+      SceneResult result = runScene(manager, fx, scene, frames);
+      double nsPerLED = result.usPerFrame * 1000.0 / totalLEDs;
+
+      if (csv)
+        printf("%s,%u,%u,%.3f,%.2f,%.2f\n", scene.name, numLEDs, totalLEDs, result.usPerFrame, nsPerLED,
+               result.sharedPerFrame);
+      else
+        printf("%-18s %8u %8u %12.2f %10.2f %8.2f\n", scene.name, numLEDs, totalLEDs, result.usPerFrame, nsPerLED,
+               result.sharedPerFrame);
+    }
+
+    if (!csv)
+      printf("\n");
+
+    delete manager;
+  }
+
+  return 0;
+}
+
+#endif
@@ -0,0 +1,112 @@
+// Arduino.h (native)
+//
+// Host stand-in for the parts of the Arduino core used by the LED render
+// pipeline. Only compiled into the `native` PlatformIO environment.
+//
+// Time is virtual: millis()/micros() only move when nativeAdvanceMicros()
+// or nativeSetMicros() is called, so effects animate deterministically
+// regardless of how fast the host runs the frame loop.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdarg.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "WString.h"
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define F(string_literal) (string_literal)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::abs;
+using std::max;
+using std::min;
+
+// === TIME ===
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// Virtual clock control (host only)
+void nativeSetMicros(uint64_t us);
+void nativeAdvanceMicros(uint64_t us);
+uint64_t nativeMicros64();
+
+// === CPU ===
+// The cycle counter follows the virtual clock at a fixed 240 MHz
+uint32_t getCpuFrequencyMhz();
+
+class EspClass
+{
+public:
+  uint32_t getCycleCount();
+};
+
+extern EspClass ESP;
+
+// === RANDOM ===
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+// === SERIAL ===
+class NativeSerial
+{
+public:
+  void begin(unsigned long baud) {}
+  void setTimeout(unsigned long timeout) {}
+  int available() { return 0; }
+  String readString() { return String(); }
+
+  // Route output to a stream (defaults to stderr). nullptr silences it.
+  void setOutput(FILE *stream) { out = stream; }
+
+  size_t print(const String &s);
+  size_t print(const char *s);
+  size_t print(char c);
+  size_t print(int n, int base = DEC);
+  size_t print(unsigned int n, int base = DEC);
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(double n, int digits = 2);
+
+  size_t println();
+  template <typename T>
+  size_t println(const T &value)
+  {
+    size_t n = print(value);
+    return n + println();
+  }
+  template <typename T>
+  size_t println(const T &value, int format)
+  {
+    size_t n = print(value, format);
+    return n + println();
+  }
+
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+  FILE *out = stderr;
+};
+
+extern NativeSerial Serial;
@@ -0,0 +1,115 @@
+// FastLED.h (native)
+//
+// Host stand-in for the slice of FastLED used by LEDStrip: the CRGB pixel
+// type, CLEDController and FastLED.addLeds<CHIPSET, PIN, ORDER>(). Nothing
+// is clocked out; showLeds() only records what would have been sent so the
+// benchmark can count shows.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+struct CRGB
+{
+  union
+  {
+    struct
+    {
+      uint8_t r;
+      uint8_t g;
+      uint8_t b;
+    };
+    uint8_t raw[3];
+  };
+
+  CRGB() : r(0), g(0), b(0) {}
+  CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+
+  bool operator==(const CRGB &other) const { return r == other.r && g == other.g && b == other.b; }
+  bool operator!=(const CRGB &other) const { return !(*this == other); }
+};
+
+enum EOrder
+{
+  RGB = 0012,
+  RBG = 0021,
+  GRB = 0102,
+  GBR = 0120,
+  BRG = 0201,
+  BGR = 0210
+};
+
+class CLEDController
+{
+public:
+  CLEDController(CRGB *data, int numLeds, uint8_t pin)
+      : data(data), numLeds(numLeds), pin(pin), showCount(0), lastBrightness(255) {}
+  virtual ~CLEDController() {}
+
+  void showLeds(uint8_t brightness = 255)
+  {
+    lastBrightness = brightness;
+    showCount++;
+  }
+
+  CLEDController &setLeds(CRGB *_data, int _numLeds)
+  {
+    data = _data;
+    numLeds = _numLeds;
+    return *this;
+  }
+
+  CRGB *leds() { return data; }
+  int size() const { return numLeds; }
+  uint8_t getPin() const { return pin; }
+
+  uint32_t getShowCount() const { return showCount; }
+  uint8_t getLastBrightness() const { return lastBrightness; }
+
+private:
+  CRGB *data;
+  int numLeds;
+  uint8_t pin;
+  uint32_t showCount;
+  uint8_t lastBrightness;
+};
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER = GRB>
+class WS2812B
+{
+};
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER = GRB>
+class WS2815
+{
+};
+
+class CFastLED
+{
+public:
+  ~CFastLED()
+  {
+    for (auto controller : controllers)
+      delete controller;
+  }
+
+  template <template <uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+  CLEDController &addLeds(CRGB *data, int numLeds)
+  {
+    CLEDController *controller = new CLEDController(data, numLeds, DATA_PIN);
+    controllers.push_back(controller);
+    return *controller;
+  }
+
+  void show()
+  {
+    for (auto controller : controllers)
+      controller->showLeds();
+  }
+
+private:
+  std::vector<CLEDController *> controllers;
+};
+
+extern CFastLED FastLED;
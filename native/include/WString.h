@@ -0,0 +1,87 @@
+// WString.h (native)
+//
+// Minimal Arduino String backed by std::string. Covers the conversions and
+// operators used by the LED pipeline and TimeProfiler, nothing more.
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class String
+{
+public:
+  String() {}
+  String(const char *cstr) : s(cstr ? cstr : "") {}
+  String(const std::string &str) : s(str) {}
+  explicit String(char c) : s(1, c) {}
+  explicit String(unsigned char value, unsigned char base = 10) : s(fromUnsigned(value, base)) {}
+  explicit String(int value, unsigned char base = 10) : s(fromSigned(value, base)) {}
+  explicit String(unsigned int value, unsigned char base = 10) : s(fromUnsigned(value, base)) {}
+  explicit String(long value, unsigned char base = 10) : s(fromSigned(value, base)) {}
+  explicit String(unsigned long value, unsigned char base = 10) : s(fromUnsigned(value, base)) {}
+  explicit String(long long value, unsigned char base = 10) : s(fromSigned(value, base)) {}
+  explicit String(unsigned long long value, unsigned char base = 10) : s(fromUnsigned(value, base)) {}
+  explicit String(float value, unsigned char decimalPlaces = 2) : s(fromDouble(value, decimalPlaces)) {}
+  explicit String(double value, unsigned char decimalPlaces = 2) : s(fromDouble(value, decimalPlaces)) {}
+
+  const char *c_str() const { return s.c_str(); }
+  unsigned int length() const { return s.length(); }
+  bool isEmpty() const { return s.empty(); }
+
+  String &operator+=(const String &rhs)
+  {
+    s += rhs.s;
+    return *this;
+  }
+  String &operator+=(const char *rhs)
+  {
+    s += rhs;
+    return *this;
+  }
+  String &operator+=(char c)
+  {
+    s += c;
+    return *this;
+  }
+
+  bool operator==(const String &rhs) const { return s == rhs.s; }
+  bool operator==(const char *rhs) const { return s == rhs; }
+  bool operator!=(const String &rhs) const { return s != rhs.s; }
+  bool operator!=(const char *rhs) const { return s != rhs; }
+  bool operator<(const String &rhs) const { return s < rhs.s; }
+  bool equals(const String &rhs) const { return s == rhs.s; }
+
+  bool startsWith(const String &prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+  int indexOf(char c) const
+  {
+    size_t pos = s.find(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+  String substring(unsigned int from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const
+  {
+    if (from >= s.size() || to <= from)
+      return String();
+    return String(s.substr(from, to - from));
+  }
+  long toInt() const { return strtol(s.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(s.c_str(), nullptr); }
+
+  friend String operator+(const String &lhs, const String &rhs) { return String(lhs.s + rhs.s); }
+  friend String operator+(const String &lhs, const char *rhs) { return String(lhs.s + rhs); }
+  friend String operator+(const char *lhs, const String &rhs) { return String(lhs + rhs.s); }
+  friend String operator+(const String &lhs, char rhs) { return String(lhs.s + rhs); }
+
+private:
+  std::string s;
+
+  static std::string fromUnsigned(unsigned long long value, unsigned char base);
+  static std::string fromSigned(long long value, unsigned char base);
+  static std::string fromDouble(double value, unsigned char decimalPlaces);
+};
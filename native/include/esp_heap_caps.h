@@ -0,0 +1,17 @@
+// esp_heap_caps.h (native)
+//
+// Host stand-in for the ESP-IDF capability allocator. Every capability is
+// served from the regular heap.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+inline void *heap_caps_malloc(size_t size, uint32_t caps) { return malloc(size); }
+inline void heap_caps_free(void *ptr) { free(ptr); }
@@ -0,0 +1,17 @@
+// freertos/semphr.h (native)
+//
+// Mutex semaphores backed by std::mutex/condition_variable. Like the real
+// thing they are not recursive: taking a mutex twice from the same task
+// blocks until the timeout.
+
+#pragma once
+
+#include "FreeRTOS.h"
+
+struct NativeSemaphore;
+typedef NativeSemaphore *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
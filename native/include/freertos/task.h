@@ -0,0 +1,24 @@
+// freertos/task.h (native)
+//
+// Tasks run on detached std::threads. Priorities and core affinity are
+// accepted and ignored; delays use the wall clock.
+
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+typedef void *TaskHandle_t;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t taskCode, const char *name, uint32_t stackDepth,
+                                   void *parameters, UBaseType_t priority, TaskHandle_t *createdTask,
+                                   BaseType_t coreId);
+void vTaskDelete(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+char *pcTaskGetName(TaskHandle_t task); // NULL for the calling task
+void vTaskDelay(TickType_t ticksToDelay);
+void vTaskDelayUntil(TickType_t *previousWakeTime, TickType_t timeIncrement);
+TickType_t xTaskGetTickCount();
+
+#define taskYIELD() nativeTaskYield()
+void nativeTaskYield();
@@ -0,0 +1,118 @@
+// Arduino.cpp (native)
+//
+// Virtual clock, PRNG, Serial and String helpers behind native/include.
+
+#include <Arduino.h>
+#include <atomic>
+
+static std::atomic<uint64_t> virtualMicros{0};
+static uint32_t randomState = 1;
+
+NativeSerial Serial;
+
+// === TIME ===
+unsigned long millis() { return (unsigned long)(virtualMicros.load() / 1000); }
+unsigned long micros() { return (unsigned long)virtualMicros.load(); }
+void delay(uint32_t ms) { virtualMicros += (uint64_t)ms * 1000; }
+void delayMicroseconds(uint32_t us) { virtualMicros += us; }
+
+void nativeSetMicros(uint64_t us) { virtualMicros = us; }
+void nativeAdvanceMicros(uint64_t us) { virtualMicros += us; }
+uint64_t nativeMicros64() { return virtualMicros.load(); }
+
+// === CPU ===
+static const uint32_t NATIVE_CPU_MHZ = 240;
+
+EspClass ESP;
+
+uint32_t getCpuFrequencyMhz() { return NATIVE_CPU_MHZ; }
+uint32_t EspClass::getCycleCount() { return (uint32_t)(virtualMicros.load() * NATIVE_CPU_MHZ); }
+
+// === RANDOM ===
+// xorshift32 so runs are reproducible across hosts and libc versions.
+static uint32_t nextRandom()
+{
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState;
+}
+
+long random(long howBig)
+{
+  if (howBig <= 0)
+    return 0;
+  return nextRandom() % howBig;
+}
+
+long random(long howSmall, long howBig)
+{
+  if (howSmall >= howBig)
+    return howSmall;
+  return random(howBig - howSmall) + howSmall;
+}
+
+void randomSeed(unsigned long seed)
+{
+  if (seed != 0)
+    randomState = (uint32_t)seed;
+}
+
+// === SERIAL ===
+size_t NativeSerial::print(const String &s) { return print(s.c_str()); }
+
+size_t NativeSerial::print(const char *s)
+{
+  if (!out)
+    return 0;
+  return fputs(s, out) < 0 ? 0 : strlen(s);
+}
+
+size_t NativeSerial::print(char c) { return out ? (fputc(c, out) == EOF ? 0 : 1) : 0; }
+size_t NativeSerial::print(int n, int base) { return print(String(n, (unsigned char)base)); }
+size_t NativeSerial::print(unsigned int n, int base) { return print(String(n, (unsigned char)base)); }
+size_t NativeSerial::print(long n, int base) { return print(String(n, (unsigned char)base)); }
+size_t NativeSerial::print(unsigned long n, int base) { return print(String(n, (unsigned char)base)); }
+size_t NativeSerial::print(double n, int digits) { return print(String(n, (unsigned char)digits)); }
+size_t NativeSerial::println() { return print("\r\n"); }
+
+size_t NativeSerial::printf(const char *format, ...)
+{
+  if (!out)
+    return 0;
+  va_list args;
+  va_start(args, format);
+  int n = vfprintf(out, format, args);
+  va_end(args);
+  return n < 0 ? 0 : n;
+}
+
+// === STRING ===
+std::string String::fromUnsigned(unsigned long long value, unsigned char base)
+{
+  if (base < 2 || base > 16)
+    base = 10;
+  char buf[66];
+  char *p = buf + sizeof(buf) - 1;
+  *p = '\0';
+  do
+  {
+    *--p = "0123456789abcdef"[value % base];
+    value /= base;
+  } while (value);
+  return std::string(p);
+}
+
+std::string String::fromSigned(long long value, unsigned char base)
+{
+  if (base == 10 && value < 0)
+    return "-" + fromUnsigned(0ULL - (unsigned long long)value, base);
+  return fromUnsigned((unsigned long long)value, base);
+}
+
+std::string String::fromDouble(double value, unsigned char decimalPlaces)
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+  return std::string(buf);
+}
@@ -0,0 +1,5 @@
+// FastLED.cpp (native)
+
+#include "FastLED.h"
+
+CFastLED FastLED;
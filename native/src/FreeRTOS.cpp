@@ -0,0 +1,123 @@
+// FreeRTOS.cpp (native)
+//
+// std::thread based implementation of the task and semaphore stand-ins.
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <chrono>
+#include <cstring>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct NativeSemaphore
+{
+  std::mutex lock;
+  std::condition_variable cv;
+  bool taken = false;
+};
+
+// Task handles point at one of these so a thread can look itself up
+struct NativeTask
+{
+  char name[16];
+};
+
+static NativeTask loopTask = {"loopTask"};
+static thread_local NativeTask *currentTask = &loopTask;
+
+static const auto bootTime = std::chrono::steady_clock::now();
+
+BaseType_t xPortGetCoreID() { return 0; }
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new NativeSemaphore(); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+  if (!semaphore)
+    return pdFALSE;
+
+  std::unique_lock<std::mutex> guard(semaphore->lock);
+  if (ticksToWait == portMAX_DELAY)
+  {
+    semaphore->cv.wait(guard, [semaphore]
+                       { return !semaphore->taken; });
+  }
+  else if (!semaphore->cv.wait_for(guard, std::chrono::milliseconds(ticksToWait), [semaphore]
+                                   { return !semaphore->taken; }))
+  {
+    return pdFALSE;
+  }
+
+  semaphore->taken = true;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+  if (!semaphore)
+    return pdFALSE;
+
+  {
+    std::lock_guard<std::mutex> guard(semaphore->lock);
+    if (!semaphore->taken)
+      return pdFALSE;
+    semaphore->taken = false;
+  }
+  semaphore->cv.notify_one();
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) { delete semaphore; }
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t taskCode, const char *name, uint32_t stackDepth,
+                                   void *parameters, UBaseType_t priority, TaskHandle_t *createdTask,
+                                   BaseType_t coreId)
+{
+  NativeTask *task = new NativeTask();
+  strncpy(task->name, name ? name : "", sizeof(task->name) - 1);
+
+  std::thread thread([task, taskCode, parameters]()
+                     {
+                       currentTask = task;
+                       taskCode(parameters); });
+  thread.detach();
+  if (createdTask)
+    *createdTask = task;
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+  // Detached threads end when their task function returns.
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return currentTask; }
+
+char *pcTaskGetName(TaskHandle_t task)
+{
+  return (task ? (NativeTask *)task : currentTask)->name;
+}
+
+void vTaskDelay(TickType_t ticksToDelay)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticksToDelay));
+}
+
+TickType_t xTaskGetTickCount()
+{
+  auto elapsed = std::chrono::steady_clock::now() - bootTime;
+  return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+void vTaskDelayUntil(TickType_t *previousWakeTime, TickType_t timeIncrement)
+{
+  TickType_t wakeTime = *previousWakeTime + timeIncrement;
+  TickType_t now = xTaskGetTickCount();
+  if ((int32_t)(wakeTime - now) > 0)
+    vTaskDelay(wakeTime - now);
+  *previousWakeTime = wakeTime;
+}
+
+void nativeTaskYield() { std::this_thread::yield(); }
@@ -512,6 +512,20 @@ void Application::setupWireless()
                              stats.updateEffectsTime = timeProfiler.getTimeUs("updateEffects");
                              stats.drawTime = timeProfiler.getTimeUs("ledFps");
 
+                             LEDStripManager *ledManager = LEDStripManager::getInstance();
+                             const FrameDeadline &deadline = ledManager->getFrameDeadline();
+                             stats.ledTargetFps = deadline.getTargetFps();
+                             stats.ledAchievedFps = deadline.getAchievedFps();
+                             stats.ledMissedFrames = deadline.getMissedDeadlines();
+                             stats.ledWorstOverrunUs = deadline.getWorstOverrunUs();
+
+                             const FrameDeadline *stripDeadline = ledManager->getStripDeadline(LEDStripType::HEADLIGHT);
+                             stats.headlightWorstOverrunUs = stripDeadline ? stripDeadline->getWorstOverrunUs() : 0;
+                             stripDeadline = ledManager->getStripDeadline(LEDStripType::TAILLIGHT);
+                             stats.taillightWorstOverrunUs = stripDeadline ? stripDeadline->getWorstOverrunUs() : 0;
+                             stripDeadline = ledManager->getStripDeadline(LEDStripType::UNDERGLOW);
+                             stats.underglowWorstOverrunUs = stripDeadline ? stripDeadline->getWorstOverrunUs() : 0;
+
                              pTX.len = sizeof(AppStats);
                              memcpy(pTX.data, &stats, sizeof(AppStats));
 
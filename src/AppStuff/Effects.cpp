@@ -48,7 +48,7 @@ void Application::setupEffects()
     headlightStrip->addEffect(nightriderEffect);
     headlightStrip->addEffect(policeEffect);
     headlightStrip->addEffect(pulseWaveEffect);
-    // headlightStrip->addEffect(auroraEffect);
+    headlightStrip->addEffect(auroraEffect);
     headlightStrip->addEffect(solidColorEffect);
     headlightStrip->addEffect(colorFadeEffect);
     headlightStrip->addEffect(commitEffect);
@@ -69,7 +69,7 @@ void Application::setupEffects()
     taillightStrip->addEffect(nightriderEffect);
     taillightStrip->addEffect(policeEffect);
     // taillightStrip->addEffect(pulseWaveEffect);
-    // taillightStrip->addEffect(auroraEffect);
+    taillightStrip->addEffect(auroraEffect);
     taillightStrip->addEffect(solidColorEffect);
     taillightStrip->addEffect(colorFadeEffect);
     taillightStrip->addEffect(commitEffect);
@@ -4,9 +4,11 @@
 #include "config.h"
 #include "IO/Wireless.h"
 #include "IO/LED/LEDStripManager.h"
+#include "IO/LED/LEDLayout.h"
 #include "Sync/SyncManager.h"
 #include "IO/StatusLed.h"
 #include "IO/TimeProfiler.h"
+#include "IO/TraceRecorder.h"
 #include <math.h>
 
 //----------------------------------------------------------------------------
@@ -59,6 +61,11 @@ void Application::begin()
 
   ledManager->startTask();
 
+  // Every LED buffer comes out of one reservation, so a configuration that
+  // does not fit shows up here and not as fragmentation later on
+  if (!ledArena.reserve(ledConfig.getArenaBytes(ArenaPlacement::INTERNAL), ledConfig.getArenaBytes(ArenaPlacement::PSRAM)))
+    Serial.println("Application: LED buffers do not fit in RAM, using the heap");
+
   if (ledConfig.headlightsEnabled)
   {
     LEDStripConfig headlights(
@@ -68,13 +75,17 @@ void Application::begin()
         ledConfig.headlightLedCount,
         OUTPUT_LED_1_PIN);
     headlights.strip->setFliped(ledConfig.headlightFlipped);
+    ledLayout.place(headlights.strip->getMainSegment(), layoutPoint(-0.8f, 1.0f), layoutPoint(0.8f, 1.0f));
+    headlights.strip->getMainSegment()->setSymmetry(SegmentSymmetry::MIRROR);
 
     ledManager->addLEDStrip(headlights);
     headlights.strip->setActive(true); // default to active so that the strip is visible when the app is started
 
     headlights.strip->getBuffer()[0] = Color(255, 0, 0);
+    headlights.strip->publishFrame();
     delay(500);
     headlights.strip->getBuffer()[0] = Color(0, 0, 0);
+    headlights.strip->publishFrame();
   }
 
   if (ledConfig.taillightsEnabled)
@@ -86,13 +97,17 @@ void Application::begin()
         ledConfig.taillightLedCount,
         OUTPUT_LED_2_PIN);
     taillights.strip->setFliped(ledConfig.taillightFlipped);
+    ledLayout.place(taillights.strip->getMainSegment(), layoutPoint(-0.8f, -1.0f), layoutPoint(0.8f, -1.0f));
+    taillights.strip->getMainSegment()->setSymmetry(SegmentSymmetry::MIRROR_CENTER);
 
     ledManager->addLEDStrip(taillights);
     taillights.strip->setActive(true); // default to active so that the strip is visible when the app is started
 
     taillights.strip->getBuffer()[0] = Color(255, 0, 0);
+    taillights.strip->publishFrame();
     delay(500);
     taillights.strip->getBuffer()[0] = Color(0, 0, 0);
+    taillights.strip->publishFrame();
   }
 
   if (ledConfig.underglowEnabled)
@@ -109,12 +124,24 @@ void Application::begin()
 
     underglow.strip->setFliped(ledConfig.underglowFlipped);
 
+    // Effects run on the whole strip, which goes up the left side, across the front and down the right
+    LEDSegment *underglowMain = underglow.strip->getMainSegment();
+    ledLayout.place(underglowMain, underglowSegmentL->startIndex, underglowSegmentL->getNumLEDs(),
+                    layoutPoint(-1.0f, -0.9f), layoutPoint(-1.0f, 0.9f));
+    ledLayout.place(underglowMain, underglowSegmentF->startIndex, underglowSegmentF->getNumLEDs(),
+                    layoutPoint(-0.9f, 1.0f), layoutPoint(0.9f, 1.0f));
+    ledLayout.place(underglowMain, underglowSegmentR->startIndex, underglowSegmentR->getNumLEDs(),
+                    layoutPoint(1.0f, 0.9f), layoutPoint(1.0f, -0.9f));
+    underglowMain->setSymmetry(SegmentSymmetry::MIRROR_CENTER);
+
     ledManager->addLEDStrip(underglow);
     underglow.strip->setActive(false); // default to inactive so that the strip is not visible when the app is started
 
     underglow.strip->getBuffer()[0] = Color(255, 0, 0);
+    underglow.strip->publishFrame();
     delay(500);
     underglow.strip->getBuffer()[0] = Color(0, 0, 0);
+    underglow.strip->publishFrame();
 
     // underglow.strip->getBuffer()[101] = Color(255, 0, 0);
 
@@ -147,10 +174,16 @@ void Application::begin()
     interior.strip->setActive(false); // default to inactive so that the strip is not visible when the app is started
 
     interior.strip->getBuffer()[0] = Color(255, 0, 0);
+    interior.strip->publishFrame();
     delay(500);
     interior.strip->getBuffer()[0] = Color(0, 0, 0);
+    interior.strip->publishFrame();
   }
 
+  // Where the strips sit around the car, for effects that draw one picture
+  // across all of them. Index 0 is on the car's left, the flip options put it there.
+  ledLayout.build();
+
   setupEffects();
   setupSequences();
   setupWireless();
@@ -178,6 +211,8 @@ void Application::begin()
     }
   }
 
+  ledArena.printReport();
+
   // Initialize SyncManager
   SyncManager *syncMgr = SyncManager::getInstance();
   syncMgr->begin();
@@ -246,15 +281,16 @@ void Application::loop()
   if (!appInitialized)
     return;
 
-  timeProfiler.increment("appFps");
-  timeProfiler.start("appLoop", TimeUnit::MICROSECONDS);
+  traceRecorder.beginEvent("Application::loop");
+  timeProfiler.increment(PROFILER_ID("appFps"));
+  timeProfiler.start(PROFILER_ID("appLoop"), TimeUnit::MICROSECONDS);
   // Update input states.
   // if (millis() - lastUpdateInputs > 20)
   // {
-    timeProfiler.start("updateInputs", TimeUnit::MICROSECONDS);
+    timeProfiler.start(PROFILER_ID("updateInputs"), TimeUnit::MICROSECONDS);
     // lastUpdateInputs = millis();
     updateInputs();
-    timeProfiler.stop("updateInputs");
+    timeProfiler.stop(PROFILER_ID("updateInputs"));
   // }
 
   // handle remote dissconnection
@@ -274,7 +310,7 @@ void Application::loop()
   brakeTapSequence3->setInput(brakeInput.get());
   brakeTapSequence3->loop();
 
-  timeProfiler.start("updateMode", TimeUnit::MICROSECONDS);
+  timeProfiler.start(PROFILER_ID("updateMode"), TimeUnit::MICROSECONDS);
   switch (mode)
   {
   case ApplicationMode::NORMAL:
@@ -306,26 +342,31 @@ void Application::loop()
     prevMode = mode;
   }
 
-  timeProfiler.stop("updateMode");
+  timeProfiler.stop(PROFILER_ID("updateMode"));
 
   // Update SyncManager
-  timeProfiler.start("updateSync", TimeUnit::MICROSECONDS);
+  timeProfiler.start(PROFILER_ID("updateSync"), TimeUnit::MICROSECONDS);
   SyncManager *syncMgr = SyncManager::getInstance();
+  traceRecorder.beginEvent("SyncManager::loop");
   syncMgr->loop();
+  traceRecorder.endEvent("SyncManager::loop");
 
-  timeProfiler.stop("updateSync");
+  timeProfiler.stop(PROFILER_ID("updateSync"));
 
   // Update BLE
-  timeProfiler.start("updateBLE", TimeUnit::MICROSECONDS);
+  timeProfiler.start(PROFILER_ID("updateBLE"), TimeUnit::MICROSECONDS);
   BLEManager *bleManager = BLEManager::getInstance();
+  traceRecorder.beginEvent("BLEManager::loop");
   bleManager->loop();
-  timeProfiler.stop("updateBLE");
+  traceRecorder.endEvent("BLEManager::loop");
+  timeProfiler.stop(PROFILER_ID("updateBLE"));
 
-  timeProfiler.start("updateEffects", TimeUnit::MICROSECONDS);
+  timeProfiler.start(PROFILER_ID("updateEffects"), TimeUnit::MICROSECONDS);
   LEDStripManager::getInstance()->updateEffects();
-  timeProfiler.stop("updateEffects");
+  timeProfiler.stop(PROFILER_ID("updateEffects"));
 
-  timeProfiler.stop("appLoop");
+  timeProfiler.stop(PROFILER_ID("appLoop"));
+  traceRecorder.endEvent("Application::loop");
 }
 
 void Application::enableNormalMode()
@@ -83,6 +83,15 @@ struct AppStats
 
   uint32_t updateEffectsTime;
   uint32_t drawTime;
+
+  // LED draw loop frame deadlines, appended so older readers still work
+  uint32_t ledTargetFps;
+  uint32_t ledAchievedFps;
+  uint32_t ledMissedFrames;
+  uint32_t ledWorstOverrunUs;
+  uint32_t headlightWorstOverrunUs;
+  uint32_t taillightWorstOverrunUs;
+  uint32_t underglowWorstOverrunUs;
 };
 
 class Application
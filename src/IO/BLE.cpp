@@ -200,6 +200,12 @@ BLEPingData BLEManager::preparePingData()
   data.batteryVoltage = batteryGetVoltage();
   data.uptime = millis() / 1000;
 
+  const FrameDeadline &deadline = ledManager->getFrameDeadline();
+  data.ledTargetFps = deadline.getTargetFps();
+  data.ledAchievedFps = deadline.getAchievedFps();
+  data.ledMissedFrames = deadline.getMissedDeadlines();
+  data.ledWorstOverrunUs = deadline.getWorstOverrunUs();
+
   return data;
 }
 
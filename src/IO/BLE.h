@@ -31,6 +31,10 @@ struct __attribute__((packed)) BLEPingData
   uint8_t batteryLevel;
   float batteryVoltage;
   uint32_t uptime;
+  uint16_t ledTargetFps;
+  uint16_t ledAchievedFps;
+  uint32_t ledMissedFrames;
+  uint32_t ledWorstOverrunUs;
 };
 
 struct __attribute__((packed)) BLEModeData
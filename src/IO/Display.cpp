@@ -97,8 +97,8 @@ void Display::noTopBar()
 
 void Display::display(void)
 {
-  timeProfiler.increment("displayFps");
-  timeProfiler.start("display", TimeUnit::MICROSECONDS);
+  timeProfiler.increment(PROFILER_ID("displayFps"));
+  timeProfiler.start(PROFILER_ID("display"), TimeUnit::MICROSECONDS);
 
   // u8g2.firstPage();
   // do
@@ -108,36 +108,36 @@ void Display::display(void)
   //     drawTopBar();
   // } while (u8g2.nextPage());
 
-  timeProfiler.start("clearBuffer", TimeUnit::MICROSECONDS);
+  timeProfiler.start(PROFILER_ID("clearBuffer"), TimeUnit::MICROSECONDS);
   u8g2.clearBuffer(); // Clear the internal buffer
-  timeProfiler.stop("clearBuffer");
+  timeProfiler.stop(PROFILER_ID("clearBuffer"));
 
-  timeProfiler.start("screenManagerDraw", TimeUnit::MICROSECONDS);
+  timeProfiler.start(PROFILER_ID("screenManagerDraw"), TimeUnit::MICROSECONDS);
   screenManager.draw();
-  timeProfiler.stop("screenManagerDraw");
+  timeProfiler.stop(PROFILER_ID("screenManagerDraw"));
 
-  timeProfiler.start("drawTopBar", TimeUnit::MICROSECONDS);
+  timeProfiler.start(PROFILER_ID("drawTopBar"), TimeUnit::MICROSECONDS);
   if (!_noTopBar)
     drawTopBar();
-  timeProfiler.stop("drawTopBar");
+  timeProfiler.stop(PROFILER_ID("drawTopBar"));
 
   // Check and draw notification if active
   if (isNotificationActive())
   {
-    timeProfiler.start("drawNotification", TimeUnit::MICROSECONDS);
+    timeProfiler.start(PROFILER_ID("drawNotification"), TimeUnit::MICROSECONDS);
     drawNotification();
-    timeProfiler.stop("drawNotification");
+    timeProfiler.stop(PROFILER_ID("drawNotification"));
   }
 
-  timeProfiler.start("sendBuffer", TimeUnit::MILLISECONDS);
+  timeProfiler.start(PROFILER_ID("sendBuffer"), TimeUnit::MILLISECONDS);
   u8g2.sendBuffer();
-  timeProfiler.stop("sendBuffer");
+  timeProfiler.stop(PROFILER_ID("sendBuffer"));
 
-  timeProfiler.start("screenUpdate", TimeUnit::MICROSECONDS);
+  timeProfiler.start(PROFILER_ID("screenUpdate"), TimeUnit::MICROSECONDS);
   screenManager.update();
-  timeProfiler.stop("screenUpdate");
+  timeProfiler.stop(PROFILER_ID("screenUpdate"));
 
-  timeProfiler.stop("display");
+  timeProfiler.stop(PROFILER_ID("display"));
 
   _noTopBar = false;
 }
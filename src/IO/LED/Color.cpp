@@ -0,0 +1,199 @@
+#include "Color.h"
+#include <Arduino.h>
+
+// Implementation of the Color structure.
+// Range of h: [0, 360), s: [0, 1], v: [0, 1]
+// Returns: RGB color with components in the range [0, 255].
+Color Color::hsv2rgb(float h, float s, float v)
+{
+  float r, g, b;
+  int i;
+  float f, p, q, t;
+
+  if (s == 0)
+  {
+    r = g = b = v;
+    return Color(r * 255, g * 255, b * 255);
+  }
+
+  h /= 60; // sector 0 to 5
+  i = floor(h);
+  f = h - i;
+  p = v * (1 - s);
+  q = v * (1 - s * f);
+  t = v * (1 - s * (1 - f));
+
+  switch (i)
+  {
+  case 0:
+    r = v;
+    g = t;
+    b = p;
+    break;
+  case 1:
+    r = q;
+    g = v;
+    b = p;
+    break;
+  case 2:
+    r = p;
+    g = v;
+    b = t;
+    break;
+  case 3:
+    r = p;
+    g = q;
+    b = v;
+    break;
+  case 4:
+    r = t;
+    g = p;
+    b = v;
+    break;
+  default: // case 5:
+    r = v;
+    g = p;
+    b = q;
+    break;
+  }
+
+  return Color(r * 255, g * 255, b * 255);
+}
+
+Color Color::rgb2hsv(uint8_t r, uint8_t g, uint8_t b)
+{
+  float h, s, v;
+  float max = std::max(r, std::max(g, b));
+  float min = std::min(r, std::min(g, b));
+
+  v = max;
+  s = max != 0 ? (max - min) / max : 0;
+
+  if (s == 0)
+  {
+    h = 0;
+  }
+  else
+  {
+    h = 60 * (g - b) / (max - min);
+  }
+
+  return Color(h, s, v);
+}
+
+// Channel sources per hue sector: 0 = val, 1 = p, 2 = falling (q), 3 = rising (t).
+// Same layout as the switch in hsv2rgb().
+static const uint8_t HSV_SECTORS[6][3] = {
+    {0, 3, 1},
+    {2, 0, 1},
+    {1, 0, 3},
+    {1, 2, 0},
+    {3, 1, 0},
+    {0, 1, 2},
+};
+
+// floor(x / 255) for x <= 65534
+static inline uint8_t floorDiv255(uint32_t x) { return (x + 1 + (x >> 8)) >> 8; }
+
+// Constants for one sat/val pair. Sums are kept scaled by 255 << 16 so a pixel
+// costs one multiply, and the truncation matches the float version:
+// floor(floor(x / 65536) / 255) == floor(x / (65536 * 255)).
+struct HsvRamp
+{
+  uint32_t val255; // val * 255 << 16
+  uint32_t p255;   // val * (255 - sat) << 16
+  uint32_t vs;     // val * sat
+  uint8_t v;
+  uint8_t p;
+
+  HsvRamp(uint8_t sat, uint8_t val)
+      : val255((uint32_t)val * 255 << 16), p255((uint32_t)val * (255 - sat) << 16), vs(val * sat),
+        v(val), p(floorDiv255(val * (255 - sat))) {}
+
+  inline Color operator()(uint16_t hue) const
+  {
+    uint32_t scaled = (uint32_t)hue * 6;
+    uint8_t sector = scaled >> 16;
+    uint32_t f = scaled & 0xFFFF;
+
+    uint8_t channels[4];
+    channels[0] = v;
+    channels[1] = p;
+    channels[2] = floorDiv255((val255 - vs * f) >> 16);
+    channels[3] = floorDiv255((p255 + vs * f) >> 16);
+
+    const uint8_t *map = HSV_SECTORS[sector];
+    return Color(channels[map[0]], channels[map[1]], channels[map[2]]);
+  }
+};
+
+Color Color::hsv2rgb16(uint16_t hue, uint8_t sat, uint8_t val)
+{
+  return HsvRamp(sat, val)(hue);
+}
+
+void Color::hsv2rgbSpan(Color *out, uint16_t count, uint32_t hue, int32_t hueStep, uint8_t sat, uint8_t val)
+{
+  HsvRamp ramp(sat, val);
+  for (uint16_t i = 0; i < count; i++)
+  {
+    out[i] = ramp(hue >> 16);
+    hue += hueStep;
+  }
+}
+
+uint32_t Color::to32Bit() const // wwrrggbb
+{
+  // return (w << 24) | (r << 16) | (g << 8) | b;
+  uint32_t v;
+  memcpy(&v, this, sizeof(v));
+  return v;
+}
+
+void Color::print() const
+{
+  char buffer[100];
+  int idx = 0;
+
+  idx += snprintf(buffer, sizeof(buffer), "R:%03d G:%03d B:%03d", r, g, b);
+
+  if (w != 255)
+    idx += snprintf(buffer + idx, sizeof(buffer) - idx, " A:%03d", w);
+
+  snprintf(buffer + idx, sizeof(buffer) - idx, " [#%02X%02X%02X]", r, g, b);
+
+  Serial.println(buffer);
+}
+
+void Color::print(const Color &color)
+{
+  color.print();
+}
+
+void Color::print(const Color *colors, uint16_t numLEDs)
+{
+  for (uint16_t i = 0; i < numLEDs; i++)
+  {
+    Serial.printf("LED %03d: ", i);
+    colors[i].print();
+  }
+}
+
+void Color::print(const CRGB *colors, uint16_t numLEDs)
+{
+  for (uint16_t i = 0; i < numLEDs; i++)
+  {
+    Serial.printf("LED %03d: ", i);
+    Color::print(Color(colors[i].r, colors[i].g, colors[i].b));
+  }
+}
+
+const Color Color::WHITE = Color(255, 255, 255);
+const Color Color::BLACK = Color(0, 0, 0);
+const Color Color::RED = Color(255, 0, 0);
+const Color Color::ORANGE = Color(255, 40, 0);
+const Color Color::GREEN = Color(0, 255, 0);
+const Color Color::BLUE = Color(0, 0, 255);
+const Color Color::YELLOW = Color(255, 255, 0);
+const Color Color::CYAN = Color(0, 255, 255);
+const Color Color::MAGENTA = Color(255, 0, 255);
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include "FastLED.h"
+
+// How an effect's pixels are combined with the layers below it
+enum class BlendMode
+{
+  OVER, // alpha blend, the default
+  ADD,  // add the colour scaled by alpha, saturating
+  MAX,  // keep the brighter of both per channel
+};
+
+// What an effect draws on a segment in the current frame. The compositor
+// skips the layers below one that hides them, and the buffer clear if that
+// layer is at the bottom anyway.
+struct Coverage
+{
+  enum Area : uint8_t
+  {
+    NONE,  // draws nothing
+    SPANS, // some pixels
+    FULL,  // every pixel
+  };
+
+  Area area;
+  bool opaque; // drawn pixels replace what is below instead of blending over it
+
+  // Only the first half of a symmetric segment was drawn, the segment
+  // mirrors it. Only honoured for a layer that hides everything below.
+  // Effects that say false draw the same on every symmetry.
+  bool symmetric = false;
+
+  bool hidesBelow() const { return area == FULL && opaque; }
+};
+
+// w is the pixel's alpha (coverage). Colours built from r, g, b are opaque,
+// a zeroed buffer is fully transparent.
+struct Color
+{
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+  uint8_t w;
+
+  Color() : r(0), g(0), b(0), w(0) {}
+  Color(uint8_t red, uint8_t green, uint8_t blue)
+      : r(red), g(green), b(blue), w(255) {}
+  Color(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha)
+      : r(red), g(green), b(blue), w(alpha) {}
+
+  static Color hsv2rgb(float h, float s, float v);
+
+  // Integer HSV to RGB. hue covers the circle in 16 bits (65536 = 360 deg),
+  // sat and val are 0-255. Matches hsv2rgb() to within 1 per channel.
+  static Color hsv2rgb16(uint16_t hue, uint8_t sat, uint8_t val);
+
+  // Fill count pixels with a hue ramp at a fixed sat and val. hue and hueStep
+  // are 16.16 fixed point hsv2rgb16 hues, so the ramp wraps around the circle.
+  static void hsv2rgbSpan(Color *out, uint16_t count, uint32_t hue, int32_t hueStep, uint8_t sat, uint8_t val);
+
+  // Degrees (any range) to a hsv2rgb16 / hsv2rgbSpan hue
+  static uint16_t hue16(float degrees) { return (uint16_t)(int32_t)(degrees * (65536.0f / 360.0f)); }
+  static uint32_t hue32(float degrees) { return (uint32_t)(int64_t)(degrees * (4294967296.0 / 360.0)); }
+  static Color rgb2hsv(uint8_t r, uint8_t g, uint8_t b);
+
+  uint32_t to32Bit() const;
+
+  static const Color WHITE;
+  static const Color BLACK;
+  static const Color RED;
+  static const Color ORANGE;
+  static const Color GREEN;
+  static const Color BLUE;
+  static const Color YELLOW;
+  static const Color CYAN;
+  static const Color MAGENTA;
+
+  bool operator==(const Color &other) const
+  {
+    return r == other.r && g == other.g && b == other.b && w == other.w;
+  }
+
+  bool operator!=(const Color &other) const
+  {
+    return !(*this == other);
+  }
+
+  /**
+   * @brief Multiplies the color by a scalar value
+   * @param scalar A floating-point value between 0 and 1
+   * @return A new Color object with RGB components scaled by the scalar value, alpha unchanged
+   */
+  Color operator*(float scalar) const
+  {
+    return Color(r * scalar, g * scalar, b * scalar, w);
+  }
+
+  // v / 255, rounded, for v <= 255 * 255
+  static inline uint8_t div255(uint16_t v)
+  {
+    v += 128;
+    return (v + (v >> 8)) >> 8;
+  }
+
+  static inline uint8_t scale(uint8_t x, uint8_t a) { return div255(x * a); }
+
+  /**
+   * @brief Composites src onto dst
+   * dst holds colour already composited over black (what the strip would show),
+   * src is a straight colour with its alpha in w. dst.w accumulates coverage.
+   */
+  static inline void blend(Color &dst, const Color &src, BlendMode mode)
+  {
+    uint8_t a = src.w;
+    if (a == 0)
+      return;
+
+    switch (mode)
+    {
+    case BlendMode::OVER:
+      if (a == 255)
+      {
+        dst = src;
+        return;
+      }
+      dst.r = div255(src.r * a + dst.r * (255 - a));
+      dst.g = div255(src.g * a + dst.g * (255 - a));
+      dst.b = div255(src.b * a + dst.b * (255 - a));
+      dst.w = div255(255 * a + dst.w * (255 - a));
+      break;
+
+    case BlendMode::ADD:
+      dst.r = std::min(255, dst.r + scale(src.r, a));
+      dst.g = std::min(255, dst.g + scale(src.g, a));
+      dst.b = std::min(255, dst.b + scale(src.b, a));
+      dst.w = std::min(255, dst.w + a);
+      break;
+
+    case BlendMode::MAX:
+      dst.r = std::max(dst.r, scale(src.r, a));
+      dst.g = std::max(dst.g, scale(src.g, a));
+      dst.b = std::max(dst.b, scale(src.b, a));
+      dst.w = std::max(dst.w, a);
+      break;
+    }
+  }
+
+  void print() const;
+  static void print(const Color &color);
+  static void print(const Color *colors, uint16_t numLEDs);
+  static void print(const CRGB *colors, uint16_t numLEDs);
+};
+
+// [[gnu::always_inline]]
+// bool allBlack(const Color *colors, uint16_t numLEDs) noexcept
+// {
+//   const uint32_t black32 = Color::BLACK.to32Bit();
+
+//   for (uint16_t i = 0; i < numLEDs; ++i)
+//   {
+//     if (colors[i].to32Bit() != black32)
+//     {
+//       return false;
+//     }
+//   }
+//   return true; // every element was black
+// }
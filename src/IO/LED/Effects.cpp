@@ -1,25 +1,99 @@
 #include "Effects.h"
-#include <Arduino.h> // For millis()
+#include <Arduino.h> // For micros()
+#include <algorithm>
 
 //
 // LEDEffect Base Class Implementation
 //
 LEDEffect::LEDEffect(uint8_t priority, bool transparent)
-    : priority(priority), transparent(transparent)
+    : priority(priority), transparent(transparent), blendMode(BlendMode::OVER), live(true)
 {
     effects.push_back(this);
 }
 
-LEDEffect::~LEDEffect() {}
+LEDEffect::~LEDEffect()
+{
+    // Leave no segment or the update list pointing at a deleted effect
+    std::vector<LEDSegment *> onSegments = segments;
+    for (auto segment : onSegments)
+        segment->removeEffect(this);
+    effects.erase(std::remove(effects.begin(), effects.end(), this), effects.end());
+}
 
 uint8_t LEDEffect::getPriority() const { return priority; }
 bool LEDEffect::isTransparent() const { return transparent; }
+BlendMode LEDEffect::getBlendMode() const { return blendMode; }
 void LEDEffect::setPriority(uint8_t prio) { priority = prio; }
 void LEDEffect::setTransparent(bool transp) { transparent = transp; }
+void LEDEffect::setBlendMode(BlendMode mode) { blendMode = mode; }
+Coverage LEDEffect::getCoverage(LEDSegment *) { return Coverage{Coverage::SPANS, false}; }
+bool LEDEffect::drawsByPosition(const LEDSegment *) const { return false; }
+bool LEDEffect::drawsAlike(const LEDSegment *, const LEDSegment *) const { return true; }
+bool LEDEffect::isLive() const { return live; }
+
+// Called from whichever task changed the effect, the segments pick the
+// change up before their next frame
+void LEDEffect::setLive(bool isLive)
+{
+    if (live == isLive)
+        return;
+
+    live = isLive;
+    for (auto segment : segments)
+        segment->liveChanged = true;
+}
 
 std::vector<LEDEffect *> LEDEffect::effects = {};
 
 std::vector<LEDEffect *> LEDEffect::getEffects() { return effects; }
+
+static uint32_t defaultFrameClock() { return micros(); }
+
+FrameContext LEDEffect::frame = {};
+uint32_t (*LEDEffect::frameClock)() = defaultFrameClock;
+uint32_t LEDEffect::lastClock = 0;
+
+void LEDEffect::setFrameClock(uint32_t (*clock)())
+{
+    frameClock = clock ? clock : defaultFrameClock;
+    frame = {};
+}
+
+const FrameContext &LEDEffect::getFrame() { return frame; }
+
+void LEDEffect::updateAll()
+{
+    // Accumulate into 64 bits so t survives the 32-bit micros() wrap
+    uint32_t now = frameClock();
+    if (frame.frame == 0)
+    {
+        frame.t = now;
+        frame.dt = 0;
+    }
+    else
+    {
+        frame.dt = now - lastClock;
+        frame.t += frame.dt;
+    }
+    lastClock = now;
+    frame.frame++;
+
+    // Shared effects sit on several segments but only advance once per frame
+    for (auto effect : effects)
+    {
+        if (effect->live && !effect->segments.empty())
+            effect->update(frame);
+    }
+}
+
+uint16_t LEDEffect::getMaxSegmentLength() const
+{
+    uint16_t maxLength = 0;
+    for (auto segment : segments)
+        maxLength = std::max(maxLength, segment->getNumLEDs());
+    return maxLength;
+}
+
 void LEDEffect::disableAllEffects()
 {
     for (auto effect : effects)
@@ -1,13 +1,25 @@
 #pragma once
 
 #include "LEDStrip.h"
+#include "Color.h"
 #include <stdint.h>
-#include "Sync/SyncManager.h"
+#include <Arduino.h>
+#include "Types.h"
 
-struct Color;
 class LEDSegment;
 class LEDStrip;
 
+// Timing shared by every effect for one frame. Times are in microseconds.
+struct FrameContext
+{
+  uint32_t frame; // frame number, counts up from 1
+  uint64_t t;     // time of this frame
+  uint32_t dt;    // time since the previous frame (0 on the first frame)
+
+  uint32_t ms() const { return t / 1000; }
+  float dtSeconds() const { return dt / 1000000.0f; }
+};
+
 // Base class for LED effects.
 class LEDEffect
 {
@@ -17,26 +29,85 @@ public:
   virtual ~LEDEffect();
   String name;
 
-  // Called each update to change animation state.
-  virtual void update(LEDSegment *segment) = 0;
+  // Called once per frame to advance animation state.
+  virtual void update(const FrameContext &frame) = 0;
 
-  // Called to render the effect into the provided LED buffer.
+  // Called for every segment the effect is on to render into its buffer.
   virtual void render(LEDSegment *segment, Color *buffer) = 0;
 
+  // What render() will draw on segment this frame, asked before rendering.
+  // Effects that draw nothing or hide everything below should say so, the
+  // default assumes some blended pixels.
+  virtual Coverage getCoverage(LEDSegment *segment);
+
+  // True if render() draws segment by its place in the layout rather than
+  // by its length, so another segment of the same length looks different
+  virtual bool drawsByPosition(const LEDSegment *segment) const;
+
+  // False if render() draws two segments of the same length differently,
+  // say by their strip type, so one may not copy the other's pixels
+  virtual bool drawsAlike(const LEDSegment *segment, const LEDSegment *other) const;
+
   virtual void onDisable() = 0;
 
+  // Live effects are updated and rendered, the others cost nothing per frame
+  bool isLive() const;
+
   uint8_t getPriority() const;
   bool isTransparent() const;
+  BlendMode getBlendMode() const;
   void setPriority(uint8_t priority);
   void setTransparent(bool transparent);
+  void setBlendMode(BlendMode mode);
 
   static std::vector<LEDEffect *> getEffects();
   static void disableAllEffects();
 
+  // Start a new frame and update every live effect that is on a segment, once.
+  static void updateAll();
+  static const FrameContext &getFrame();
+
+  // Microsecond clock the frames are timed with. Defaults to micros().
+  static void setFrameClock(uint32_t (*clock)());
+
 protected:
   uint8_t priority;
   bool transparent;
+  BlendMode blendMode;
+
+  // Effects call this when they start or stop having anything to animate or
+  // draw, fades included. Effects start live.
+  void setLive(bool live);
+
+  // Blend a pixel onto the layers below with this effect's blend mode.
+  // Colour alpha (w) sets the coverage, so fades show the layer below.
+  void setPixel(Color *buffer, uint16_t index, const Color &color) const
+  {
+    Color::blend(buffer[index], color, blendMode);
+  }
+
+  // Segments this effect is on, kept up to date by LEDSegment
+  std::vector<LEDSegment *> segments;
+  uint16_t getMaxSegmentLength() const;
 
 private:
+  friend class LEDSegment;
+
+  bool live;
+
+  // Bottom layer this effect last drew, copied onto the next segment of the
+  // same shape in the same frame instead of drawing it again
+  struct SharedRender
+  {
+    uint32_t frame = 0; // none yet
+    const LEDSegment *drawnBy = nullptr; // only compared, it may be gone
+    uint16_t drawnLength = 0; // LEDs render() drew before the segment mirrored them
+    std::vector<Color> colors; // sized when the effect joins a second segment
+  };
+  SharedRender shared;
+
   static std::vector<LEDEffect *> effects;
+  static FrameContext frame;
+  static uint32_t (*frameClock)();
+  static uint32_t lastClock;
 };
\ No newline at end of file
@@ -2,11 +2,11 @@
 #include <cmath>
 #include <Arduino.h>
 #include "../LEDStrip.h"
+#include "../Wave.h"
 
 AuroraEffect::AuroraEffect(uint8_t priority, bool transparent)
     : LEDEffect(priority, transparent),
       active(false),
-      lastUpdateTime(0),
       time(0.0f),
       movementSpeed(0.2f),
       waveIntensity(0.6f),
@@ -14,9 +14,11 @@ AuroraEffect::AuroraEffect(uint8_t priority, bool transparent)
       minHue(140.0f),
       maxHue(270.0f),
       saturationMin(0.7f),
-      saturationMax(1.0f)
+      saturationMax(1.0f),
+      field(LayoutAxis::AROUND)
 {
   name = "Aurora";
+  setLive(false);
 
   phaseOffsets[0] = 0.0f;
   amplitudes[0] = 1.0f;
@@ -34,21 +36,23 @@ AuroraEffect::AuroraEffect(uint8_t priority, bool transparent)
   amplitudes[2] = 0.4f;
   frequencies[2] = 3.0f;
   hues[2] = 240.0f; // Purple-blue
+
+  for (int i = 0; i < NUM_SINES; i++)
+    timePhases[i] = 0;
 }
 
 void AuroraEffect::setActive(bool _active)
 {
-  active = _active;
-  if (active && lastUpdateTime == 0)
+  if (_active && !active)
   {
-    lastUpdateTime = millis();
-
     // Randomize phase offsets when activating for variety
     for (int i = 0; i < NUM_WAVES; i++)
     {
       phaseOffsets[i] = random(0, 1000) / 100.0f;
     }
   }
+  active = _active;
+  setLive(active);
 }
 
 bool AuroraEffect::isActive() const
@@ -56,50 +60,27 @@ bool AuroraEffect::isActive() const
   return active;
 }
 
-float AuroraEffect::computeWave(float pos, float time, int waveIndex)
-{
-  // Different wave patterns for each component to create organic movement
-  switch (waveIndex)
-  {
-  case 0:
-    // Main sine wave
-    return amplitudes[waveIndex] * 0.5f * (1.0f + sinf(2.0f * PI * (frequencies[waveIndex] * pos + time + phaseOffsets[waveIndex])));
-
-  case 1:
-    // Secondary wave with more complex shape (composite of two sine waves)
-    return amplitudes[waveIndex] * 0.5f * (sinf(2.0f * PI * (frequencies[waveIndex] * pos + time * 0.7f + phaseOffsets[waveIndex])) + 0.3f * sinf(2.0f * PI * (frequencies[waveIndex] * 3 * pos + time * 1.3f)));
-
-  case 2:
-    // Fast subtle details using a different function
-    return amplitudes[waveIndex] * 0.5f * (1.0f + sinf(2.0f * PI * (frequencies[waveIndex] * pos + time * 1.5f + phaseOffsets[waveIndex] + pos * 3.0f)));
-
-  default:
-    return 0.0f;
-  }
-}
-
-void AuroraEffect::update(LEDSegment *segment)
+void AuroraEffect::update(const FrameContext &frame)
 {
   if (!active)
     return;
 
-  unsigned long currentTime = millis();
-  if (lastUpdateTime == 0)
-  {
-    lastUpdateTime = currentTime;
-    return;
-  }
-
-  // Calculate elapsed time in seconds
-  unsigned long dtMillis = currentTime - lastUpdateTime;
-  float dtSeconds = dtMillis / 1000.0f;
-  lastUpdateTime = currentTime;
+  float dtSeconds = frame.dtSeconds();
 
   // Update animation time
-  time += movementSpeed * dtSeconds;
+  float advance = movementSpeed * dtSeconds;
+  time += advance;
+  if (time >= 10.0f)
+    time -= 10.0f; // only used modulo 10, and a growing float loses precision
+
+  // Each sine moves at its own multiple of the animation time
+  timePhases[0] += Wave::phase(advance);
+  timePhases[1] += Wave::phase(advance * 0.7f);
+  timePhases[2] += Wave::phase(advance * 1.3f);
+  timePhases[3] += Wave::phase(advance * 1.5f);
 
   // Periodically adjust the hues slightly to create color variation over time
-  if (fmod(time, 10.0f) < 0.1f) // Every ~10 seconds
+  if (time < 0.1f) // Every ~10 seconds
   {
     for (int i = 0; i < NUM_WAVES; i++)
     {
@@ -120,84 +101,153 @@ void AuroraEffect::render(LEDSegment *segment, Color *buffer)
   if (!active)
     return;
 
+  if (field.render(segment, buffer, [this](const uint16_t *coords, uint16_t count, Color *colors)
+                   { renderField(coords, count, colors); }))
+    return;
+
   uint16_t numLEDs = segment->getNumLEDs();
-  bool isHeadlight = (segment->getParentStrip()->getType() == LEDStripType::HEADLIGHT);
+  bool mirrored = segment->isSymmetric();
   uint16_t midPoint = numLEDs / 2;
 
-  // For headlights, we'll only process the first half and mirror it
-  uint16_t ledsToProcess = isHeadlight ? midPoint + (numLEDs % 2) : numLEDs;
+  // Symmetric segments mirror the first half themselves
+  uint16_t ledsToProcess = segment->getHalfLength();
 
-  for (uint16_t i = 0; i < ledsToProcess; i++)
+  // Normalized position [0, 1] of the first LED and its step per LED. When
+  // mirrored it is the distance from the center (1 at the edge, 0 at the center).
+  float posStart = 0.0f;
+  float posStep = 0.0f;
+  if (mirrored && midPoint > 0)
   {
-    // Calculate normalized position [0, 1] along the strip
-    float pos;
-
-    if (isHeadlight)
-    {
-      // For headlights, calculate distance from center (0 at center, 1 at edge)
-      pos = static_cast<float>(abs(midPoint - i)) / midPoint;
-    }
-    else
-    {
-      // For other strips, maintain original behavior
-      pos = static_cast<float>(i) / (numLEDs - 1);
-    }
+    posStart = 1.0f;
+    posStep = -1.0f / midPoint;
+  }
+  else if (!mirrored && numLEDs > 1)
+  {
+    posStep = 1.0f / (numLEDs - 1);
+  }
 
-    // Calculate the combined influence of the different wave components
-    float totalWave = 0.0f;
-    float maxPossibleValue = 0.0f;
+  Shading shading = getShading();
 
-    for (int w = 0; w < NUM_WAVES; w++)
-    {
-      totalWave += computeWave(pos, time, w);
-      maxPossibleValue += amplitudes[w];
-    }
+  // Every sine's phase is linear in pos, so each one is a start phase plus a
+  // step per LED
+  uint32_t phases[NUM_SINES];
+  uint32_t steps[NUM_SINES];
+  for (int s = 0; s < NUM_SINES; s++)
+  {
+    phases[s] = timePhases[s] + Wave::phase(shading.offsets[s] + shading.spatial[s] * posStart);
+    steps[s] = Wave::phase(shading.spatial[s] * posStep);
+  }
 
-    // Normalize the combined wave value
-    float waveValue = totalWave / maxPossibleValue;
+  for (uint16_t i = 0; i < ledsToProcess; i++)
+  {
+    Color color = shade(shading, phases);
 
-    // Apply the wave intensity parameter
-    waveValue = waveValue * waveIntensity + (1.0f - waveIntensity) * 0.5f;
+    for (int s = 0; s < NUM_SINES; s++)
+      phases[s] += steps[s];
 
-    // Determine which color component is most dominant at this position
-    int dominantWave = 0;
-    float maxWaveValue = 0.0f;
+    // Apply to buffer
+    buffer[i] = color;
+  }
+}
 
-    for (int w = 0; w < NUM_WAVES; w++)
-    {
-      float value = computeWave(pos, time, w);
-      if (value > maxWaveValue)
-      {
-        maxWaveValue = value;
-        dominantWave = w;
-      }
-    }
+// Placed segments are not evenly spaced in the field, so each position gets
+// its own phases
+void AuroraEffect::renderField(const uint16_t *coords, uint16_t count, Color *colors)
+{
+  Shading shading = getShading();
 
-    // Get the hue from the dominant wave
-    float hue = hues[dominantWave];
+  for (uint16_t i = 0; i < count; i++)
+  {
+    float pos = coords[i] / (float)LAYOUT_ONE;
+    uint32_t phases[NUM_SINES];
+    for (int s = 0; s < NUM_SINES; s++)
+      phases[s] = timePhases[s] + Wave::phase(shading.offsets[s] + shading.spatial[s] * pos);
 
-    // Vary saturation based on wave intensity
-    float saturation = saturationMin + (saturationMax - saturationMin) * waveValue;
+    colors[i] = shade(shading, phases);
+  }
+}
 
-    // Vary brightness based on wave value (brighter at peaks)
-    float brightness = waveValue * intensity;
+AuroraEffect::Shading AuroraEffect::getShading() const
+{
+  Shading shading;
+
+  // wave 0: sin(frequency * pos + time + offset)
+  // wave 1: sin(frequency * pos + 0.7 time + offset) + 0.3 sin(3 frequency * pos + 1.3 time)
+  // wave 2: sin((frequency + 3) * pos + 1.5 time + offset)
+  const float spatial[NUM_SINES] = {frequencies[0], frequencies[1], frequencies[1] * 3, frequencies[2] + 3.0f};
+  const float offsets[NUM_SINES] = {phaseOffsets[0], phaseOffsets[1], 0.0f, phaseOffsets[2]};
+  for (int s = 0; s < NUM_SINES; s++)
+  {
+    shading.spatial[s] = spatial[s];
+    shading.offsets[s] = offsets[s];
+  }
 
-    // Create the color
-    Color color = Color::hsv2rgb(hue, saturation, brightness);
+  // Wave values are Q16 (1.0 = 65536)
+  float maxPossibleValue = 0.0f;
+  for (int w = 0; w < NUM_WAVES; w++)
+  {
+    shading.amplitude[w] = amplitudes[w] * 32768; // Q15
+    maxPossibleValue += amplitudes[w];
+    shading.hue[w] = Color::hue16(hues[w]);
+  }
 
-    // Apply to buffer
-    buffer[i] = color;
+  // waveValue = total / maxPossibleValue * waveIntensity + (1 - waveIntensity) / 2
+  shading.waveScale = waveIntensity / maxPossibleValue * 4096; // Q12
+  shading.waveOffset = (1.0f - waveIntensity) * 0.5f * 65536;
+  shading.saturationBase = saturationMin * 255;
+  shading.saturationRange = (saturationMax - saturationMin) * 255;
+  shading.brightnessScale = intensity * 255;
+  return shading;
+}
 
-    // For headlights, mirror to the other side
-    if (isHeadlight && i != midPoint)
-    { // Skip mirroring the center LED
-      uint16_t mirrorIndex = numLEDs - i - 1;
-      buffer[mirrorIndex] = color;
+Color AuroraEffect::shade(const Shading &shading, const uint32_t *phases)
+{
+  // One evaluation per sine, reused for both the sum and the dominant wave
+  int32_t waves[NUM_WAVES];
+  waves[0] = (shading.amplitude[0] * Wave::unit(phases[0])) >> 15;
+  waves[1] = (shading.amplitude[1] * (Wave::sin(phases[1]) + ((Wave::sin(phases[2]) * 19661) >> 16))) >> 15; // 0.3 = 19661 / 65536
+  waves[2] = (shading.amplitude[2] * Wave::unit(phases[3])) >> 15;
+
+  int32_t totalWave = waves[0] + waves[1] + waves[2];
+
+  // Normalize the combined wave value and apply the wave intensity
+  int32_t waveValue = ((totalWave * shading.waveScale) >> 12) + shading.waveOffset;
+  waveValue = constrain(waveValue, 0, 65535);
+
+  // Determine which color component is most dominant at this position
+  int dominantWave = 0;
+  int32_t maxWaveValue = 0;
+  for (int w = 0; w < NUM_WAVES; w++)
+  {
+    if (waves[w] > maxWaveValue)
+    {
+      maxWaveValue = waves[w];
+      dominantWave = w;
     }
   }
+
+  // Saturation and brightness follow the wave (brighter at peaks)
+  uint8_t saturation = shading.saturationBase + ((shading.saturationRange * waveValue) >> 16);
+  uint8_t brightness = (shading.brightnessScale * waveValue) >> 16;
+
+  // Create the color from the dominant wave's hue
+  return Color::hsv2rgb16(shading.hue[dominantWave], saturation, brightness);
+}
+
+Coverage AuroraEffect::getCoverage(LEDSegment *segment)
+{
+  // Placed segments take the whole field, which is not mirrored by index
+  bool symmetric = segment->isSymmetric() && ledLayout.find(segment) == nullptr;
+  return active ? Coverage{Coverage::FULL, true, symmetric} : Coverage{Coverage::NONE, false};
+}
+
+bool AuroraEffect::drawsByPosition(const LEDSegment *segment) const
+{
+  return field.renders(segment);
 }
 
 void AuroraEffect::onDisable()
 {
   active = false;
+  setLive(false);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Effects.h"
+#include "../LEDLayout.h"
 #include <stdint.h>
 
 class AuroraEffect : public LEDEffect
@@ -9,8 +10,10 @@ public:
   // Constructs the Aurora Borealis effect
   AuroraEffect(uint8_t priority = 0, bool transparent = false);
 
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
+  virtual bool drawsByPosition(const LEDSegment *segment) const override;
   virtual void onDisable() override;
 
   // Activate or disable the effect
@@ -31,11 +34,8 @@ public:
 private:
   bool active;
 
-  // Time tracking
-  unsigned long lastUpdateTime;
-
   // Animation state variables
-  float time; // Accumulated time for animation
+  float time; // Accumulated time for the hue drift, wraps every 10
 
   // Wave phase offsets for each component
   static const int NUM_WAVES = 3;
@@ -44,6 +44,28 @@ private:
   float frequencies[NUM_WAVES];
   float hues[NUM_WAVES];
 
-  // Helper function to compute a smooth, organic-looking wave
-  float computeWave(float pos, float time, int waveIndex);
+  // Time part of each sine's phase (Wave units). Wave 1 is the sum of two
+  // sines, so there is one more than NUM_WAVES.
+  static const int NUM_SINES = NUM_WAVES + 1;
+  uint32_t timePhases[NUM_SINES];
+
+  // Per-frame constants of the colour math, fixed point where used per LED
+  struct Shading
+  {
+    float spatial[NUM_SINES]; // cycles per unit of position
+    float offsets[NUM_SINES];
+    int32_t amplitude[NUM_WAVES]; // Q15
+    uint16_t hue[NUM_WAVES];
+    int32_t waveScale; // Q12
+    int32_t waveOffset;
+    int32_t saturationBase;
+    int32_t saturationRange;
+    int32_t brightnessScale;
+  };
+  Shading getShading() const;
+  static Color shade(const Shading &shading, const uint32_t *phases);
+
+  // Placed segments show the aurora flowing from the front to the rear of the car
+  LayoutField field;
+  void renderField(const uint16_t *coords, uint16_t count, Color *colors);
 };
\ No newline at end of file
@@ -11,8 +11,8 @@ static inline float easeInQuadratic(float t)
 
 BrakeLightEffect::BrakeLightEffect(uint8_t priority, bool transparent)
     : LEDEffect(priority, transparent),
-      lastUpdate(0),
       brakeActive(false),
+      isReversing(false),
       // When active, fadeProgress is 1. When brakes are released it counts down.
       fadeProgress(1.0f),
       // Full brightness when braking; when released this is immediately set to 0.3.
@@ -36,6 +36,7 @@ void BrakeLightEffect::setActive(bool active)
   }
 
   brakeActive = active;
+  setLive(true); // either way there is a fade to show
 
   if (brakeActive)
   {
@@ -67,27 +68,18 @@ bool BrakeLightEffect::getIsReversing() const
   return isReversing;
 }
 
-void BrakeLightEffect::update(LEDSegment *segment)
+void BrakeLightEffect::update(const FrameContext &frame)
 {
-  unsigned long currentTime = millis();
-  if (lastUpdate == 0)
-  {
-    lastUpdate = currentTime;
-    return;
-  }
-
-  // Compute elapsed time in seconds.
-  unsigned long dtMillis = currentTime - lastUpdate;
-  float dtSeconds = dtMillis / 1000.0f;
-  lastUpdate = currentTime;
+  float dtSeconds = frame.dtSeconds();
 
   if (!brakeActive)
   {
     // Decrease fadeProgress linearly over fadeDuration seconds.
     fadeProgress -= dtSeconds / fadeDuration;
-    if (fadeProgress < 0.0f)
+    if (fadeProgress <= 0.0f)
     {
       fadeProgress = 0.0f;
+      setLive(false);
     }
   }
   else
@@ -159,12 +151,22 @@ void BrakeLightEffect::render(LEDSegment *segment, Color *buffer)
     // Final LED brightness is the product of overall brightness and spatial factor.
     float ledBrightness = overallBrightness * spatialFactor;
 
-    uint8_t redVal = static_cast<uint8_t>(255 * ledBrightness);
-    if (redVal > 10)
-      buffer[i] = Color(redVal, 0, 0);
+    // Fade through alpha so the taillight underneath stays lit
+    setPixel(buffer, i, Color(255, 0, 0, static_cast<uint8_t>(255 * ledBrightness)));
   }
 }
 
+Coverage BrakeLightEffect::getCoverage(LEDSegment *segment)
+{
+  if (brakeActive)
+    return Coverage{isReversing ? Coverage::SPANS : Coverage::FULL, true};
+
+  // Fading out blends over the layers below
+  if (isReversing || fadeProgress <= 0.0f)
+    return Coverage{Coverage::NONE, false};
+  return Coverage{Coverage::FULL, false};
+}
+
 void BrakeLightEffect::onDisable()
 {
   brakeActive = false;
@@ -8,8 +8,9 @@ class BrakeLightEffect : public LEDEffect
 public:
   // Constructs a brake light effect for a given number of LEDs.
   BrakeLightEffect(uint8_t priority = 0, bool transparent = false);
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
   virtual void onDisable() override;
 
   // Set whether the brakes are active.
@@ -19,8 +20,6 @@ public:
   bool getIsReversing() const;
 
 private:
-  unsigned long lastUpdate;
-
   bool brakeActive;
   bool isReversing;
 
@@ -22,22 +22,22 @@ ColorFadeEffect::ColorFadeEffect(uint8_t priority, bool transparent)
       fadeTime(1.0f),    // Default: fade over 1 second
       progress(0.0f),
       currentColorIndex(0),
-      inFadePhase(false),
-      lastUpdateTime(0)
+      inFadePhase(false)
 {
   name = "ColorFade";
+  setLive(false);
 }
 
 void ColorFadeEffect::setActive(bool _active)
 {
-  active = _active;
-  if (_active && lastUpdateTime == 0)
+  if (_active && !active)
   {
-    lastUpdateTime = SyncManager::syncMillis();
     progress = 0.0f;
     currentColorIndex = 0;
     inFadePhase = false;
   }
+  active = _active;
+  setLive(active);
 }
 
 bool ColorFadeEffect::isActive() const
@@ -48,6 +48,7 @@ bool ColorFadeEffect::isActive() const
 void ColorFadeEffect::setSyncData(ColorFadeSyncData syncData)
 {
   active = syncData.active;
+  setLive(active);
   holdTime = syncData.holdTime;
   fadeTime = syncData.fadeTime;
   progress = syncData.progress;
@@ -73,25 +74,13 @@ ColorFadeSyncData ColorFadeEffect::getSyncData()
   return syncData;
 }
 
-void ColorFadeEffect::update(LEDSegment *segment)
+void ColorFadeEffect::update(const FrameContext &frame)
 {
   // Return if the effect is not active
   if (!active)
     return;
 
-  unsigned long currentTime = SyncManager::syncMillis();
-  
-  // Initialize last update time if needed
-  if (lastUpdateTime == 0)
-  {
-    lastUpdateTime = currentTime;
-    return;
-  }
-
-  // Calculate elapsed time in seconds
-  unsigned long dtMillis = currentTime - lastUpdateTime;
-  float dtSeconds = dtMillis / 1000.0f;
-  lastUpdateTime = currentTime;
+  float dtSeconds = frame.dtSeconds();
 
   // Update progress based on current phase
   float phaseTime = inFadePhase ? fadeTime : holdTime;
@@ -137,9 +126,15 @@ void ColorFadeEffect::render(LEDSegment *segment, Color *buffer)
   }
 }
 
+Coverage ColorFadeEffect::getCoverage(LEDSegment *segment)
+{
+  return active ? Coverage{Coverage::FULL, true} : Coverage{Coverage::NONE, false};
+}
+
 void ColorFadeEffect::onDisable()
 {
   active = false;
+  setLive(false);
 }
 
 Color ColorFadeEffect::interpolateColors(const Color& fromColor, const Color& toColor, float t)
@@ -10,8 +10,9 @@ public:
   // Constructs the ColorFade effect with default timing parameters
   ColorFadeEffect(uint8_t priority = 0, bool transparent = false);
 
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
   virtual void onDisable() override;
 
   // Activate or disable the effect
@@ -34,9 +35,6 @@ private:
   uint8_t currentColorIndex; // Index of the current color in the list
   bool inFadePhase;          // true if currently fading, false if holding
 
-  // Timing
-  unsigned long lastUpdateTime;
-
   // Hardcoded color list
   static const Color colorList[];
   static const uint8_t numColors;
@@ -1,5 +1,6 @@
 #include "CommitEffect.h"
-#include <algorithm>
+#include "../LEDArena.h"
+#include <climits>
 
 CommitEffect::CommitEffect(uint8_t priority, bool transparent)
     : LEDEffect(priority, transparent),
@@ -8,11 +9,20 @@ CommitEffect::CommitEffect(uint8_t priority, bool transparent)
       trailLength(15000),             // 15 LED trail length * 1000 (15.0 * 1000)
       commitInterval(1200),           // New commit every 1200 milliseconds (1.2 seconds)
       headR(0), headG(0), headB(255), // Bright green for commits
+      firstCommit(0),
+      commitCount(0),
       timeSinceLastCommit(0),
-      lastUpdateTime(0),
+      pendingMicros(0),
       syncEnabled(true)
 {
   name = "Commit";
+  setLive(false);
+  commits = ledArena.allocate<Commit>(MAX_COMMITS, ArenaPlacement::INTERNAL, name + " commits");
+}
+
+CommitEffect::~CommitEffect()
+{
+  ledArena.release(commits);
 }
 
 void CommitEffect::setActive(bool _active)
@@ -21,13 +31,15 @@ void CommitEffect::setActive(bool _active)
     return;
 
   active = _active;
+  setLive(active);
 
   if (active)
   {
     // Reset state
-    commits.clear();
+    firstCommit = 0;
+    commitCount = 0;
     timeSinceLastCommit = 0;
-    lastUpdateTime = SyncManager::syncMillis();
+    pendingMicros = 0;
   }
 }
 
@@ -39,6 +51,7 @@ bool CommitEffect::isActive() const
 void CommitEffect::setSyncData(CommitSyncData syncData)
 {
   active = syncData.active;
+  setLive(active);
   commitSpeed = syncData.commitSpeed;
   trailLength = syncData.trailLength;
   commitInterval = syncData.commitInterval;
@@ -62,29 +75,24 @@ CommitSyncData CommitEffect::getSyncData()
   };
 }
 
-void CommitEffect::update(LEDSegment *segment)
+void CommitEffect::update(const FrameContext &frame)
 {
   if (!active)
     return;
 
-  unsigned long currentTime = SyncManager::syncMillis();
-  if (lastUpdateTime == 0)
-  {
-    lastUpdateTime = currentTime;
-    return;
-  }
-
-  // Calculate elapsed time in milliseconds
-  uint32_t deltaTimeMillis = currentTime - lastUpdateTime;
-  lastUpdateTime = currentTime;
+  // Step in whole milliseconds and carry the remainder to the next frame
+  pendingMicros += frame.dt;
+  uint32_t deltaTimeMillis = pendingMicros / 1000;
+  pendingMicros %= 1000;
 
-  uint16_t numLEDs = segment->getNumLEDs();
+  // Commits live until they have left the longest segment the effect is on
+  uint16_t numLEDs = getMaxSegmentLength();
 
   // Update time since last commit
   timeSinceLastCommit += deltaTimeMillis;
 
-  // Spawn new commit if interval has passed
-  if (timeSinceLastCommit >= commitInterval)
+  // Spawn new commit if interval has passed and there is room for it
+  if (timeSinceLastCommit >= commitInterval && commitCount < MAX_COMMITS)
   {
     spawnCommit();
     timeSinceLastCommit = 0;
@@ -100,36 +108,83 @@ void CommitEffect::render(LEDSegment *segment, Color *buffer)
     return;
 
   uint16_t numLEDs = segment->getNumLEDs();
+  uint16_t half = numLEDs / 2;
+  // Symmetric segments mirror the first half, the centre LED included
+  bool mirrored = segment->isSymmetric();
+  uint16_t leftEnd = mirrored ? segment->getHalfLength() : half;
+  int32_t centerPos = ((numLEDs - 1) * 1000) / 2; // Fixed point center position
+  Color head(headR, headG, headB);
+
+  // Trail brightness falls off linearly from 255 at the head to 0 at
+  // trailLength behind it, in 16.16 fixed point
+  uint32_t falloff = (255u << 16) / (trailLength > 0 ? trailLength : 1);
+
+  // Each pixel takes the trail of the nearest head moving away from it.
+  // Newer commits are closer to center, and their trails cover older ones.
+  auto trail = [&](int32_t distance) -> Color
+  {
+    if (distance <= 0 || distance > (int32_t)trailLength)
+      return Color();
+    uint8_t level = ((255u << 16) - (uint32_t)distance * falloff) >> 16;
+    return Color(Color::scale(headR, level), Color::scale(headG, level), Color::scale(headB, level));
+  };
+
+  // Left half: heads move towards 0 and trail towards center. Walk outward
+  // in, keeping the nearest head on the edge side (oldest commits first).
+  uint8_t next = 0;
+  int32_t nearest = INT32_MIN;
+  for (uint16_t i = 0; i < leftEnd; i++)
+  {
+    int32_t pos = i * 1000;
+    while (next < commitCount && centerPos - (int32_t)getCommit(next).position < pos)
+      nearest = centerPos - (int32_t)getCommit(next++).position;
+    buffer[i] = nearest == INT32_MIN ? Color() : trail(pos - nearest);
+  }
 
-  // Clear the buffer
-  // for (uint16_t i = 0; i < numLEDs; i++)
-  // {
-  //   buffer[i] = Color(0, 0, 0);
-  // }
-  memset(buffer, 0, numLEDs * sizeof(Color));
+  // Right half: heads move towards the end. Walk center out, keeping the
+  // nearest head on the edge side (newest commits first).
+  next = 0;
+  for (uint16_t i = leftEnd; i < numLEDs && !mirrored; i++)
+  {
+    int32_t pos = i * 1000;
+    while (next < commitCount && centerPos + (int32_t)getCommit(commitCount - 1 - next).position <= pos)
+      next++;
+    buffer[i] = next < commitCount ? trail(centerPos + (int32_t)getCommit(commitCount - 1 - next).position - pos) : Color();
+  }
 
-  // Render all commits
-  for (const auto &commit : commits)
+  // Heads go on top of every trail
+  for (uint8_t c = 0; c < commitCount; c++)
   {
-    renderCommit(commit, segment, buffer);
+    int32_t position = getCommit(c).position;
+
+    int leftIndex = (centerPos - position) / 1000;
+    if (leftIndex >= 0 && leftIndex < static_cast<int>(mirrored ? leftEnd : numLEDs))
+      buffer[leftIndex] = head;
+
+    int rightIndex = (centerPos + position) / 1000;
+    if (!mirrored && rightIndex >= 0 && rightIndex < static_cast<int>(numLEDs))
+      buffer[rightIndex] = head;
   }
 }
 
+Coverage CommitEffect::getCoverage(LEDSegment *segment)
+{
+  // Every pixel is written, the dark ones clear
+  return active ? Coverage{Coverage::FULL, true, segment->isSymmetric()} : Coverage{Coverage::NONE, false};
+}
+
 void CommitEffect::onDisable()
 {
   active = false;
+  setLive(false);
 }
 
 void CommitEffect::spawnCommit()
 {
-  Commit newCommit;
-  newCommit.positionLeft = 0;  // Start at center (fixed point 0)
-  newCommit.positionRight = 0; // Start at center (fixed point 0)
+  Commit &newCommit = commits[(firstCommit + commitCount) % MAX_COMMITS];
+  newCommit.position = 0; // Start at center (fixed point 0)
   newCommit.age = 0;
-  newCommit.activeLeft = true;
-  newCommit.activeRight = true;
-
-  commits.push_back(newCommit);
+  commitCount++;
 }
 
 void CommitEffect::updateCommits(uint32_t deltaTimeMillis, uint16_t numLEDs)
@@ -137,107 +192,27 @@ void CommitEffect::updateCommits(uint32_t deltaTimeMillis, uint16_t numLEDs)
   uint32_t centerPos = ((numLEDs - 1) * 1000) / 2; // Fixed point center position
   uint32_t maxDistance = centerPos;                // Maximum distance from center to edge
 
-  // Update each commit
-  for (auto &commit : commits)
+  // commitSpeed is in LED positions per second * 1000
+  // deltaTimeMillis is in milliseconds
+  // Position increment = (commitSpeed * deltaTimeMillis) / 1000
+  uint32_t step = (commitSpeed * deltaTimeMillis) / 1000;
+
+  for (uint8_t c = 0; c < commitCount; c++)
   {
+    Commit &commit = commits[(firstCommit + c) % MAX_COMMITS];
     commit.age += deltaTimeMillis;
-
-    if (commit.activeLeft)
-    {
-      // commitSpeed is in LED positions per second * 1000
-      // deltaTimeMillis is in milliseconds
-      // Position increment = (commitSpeed * deltaTimeMillis) / 1000
-      commit.positionLeft += (commitSpeed * deltaTimeMillis) / 1000;
-
-      // Deactivate if it has moved beyond the edge plus trail length
-      if (commit.positionLeft > maxDistance + trailLength)
-      {
-        commit.activeLeft = false;
-      }
-    }
-
-    if (commit.activeRight)
-    {
-      // Same calculation for right side
-      commit.positionRight += (commitSpeed * deltaTimeMillis) / 1000;
-
-      // Deactivate if it has moved beyond the edge plus trail length
-      if (commit.positionRight > maxDistance + trailLength)
-      {
-        commit.activeRight = false;
-      }
-    }
+    commit.position += step;
   }
 
-  // Remove inactive commits
-  commits.erase(
-      std::remove_if(commits.begin(), commits.end(),
-                     [](const Commit &c)
-                     { return !c.activeLeft && !c.activeRight; }),
-      commits.end());
-}
-
-void CommitEffect::renderCommit(const Commit &commit, LEDSegment *segment, Color *buffer)
-{
-  uint16_t numLEDs = segment->getNumLEDs();
-  uint32_t centerPos = ((numLEDs - 1) * 1000) / 2; // Fixed point center position
-
-  // Render left-moving commit
-  if (commit.activeLeft)
+  // Remove commits that have moved beyond the edge plus trail length
+  while (commitCount > 0 && commits[firstCommit].position > maxDistance + trailLength)
   {
-    // headPos in fixed point (multiply by 1000)
-    int32_t headPos = (int32_t)centerPos - (int32_t)commit.positionLeft;
-    int headIndex = headPos / 1000; // Convert back to LED index
-
-    // Draw head
-    if (headIndex >= 0 && headIndex < static_cast<int>(numLEDs))
-      buffer[headIndex] = Color(headR, headG, headB);
-
-    // Draw trail
-    for (int i = 0; i < static_cast<int>(numLEDs / 2); i++)
-    {
-      if (i == headIndex)
-        continue; // Skip head
-
-      // Distance in fixed point (multiply LED index by 1000 to match headPos scale)
-      int32_t distance = (i * 1000) - headPos; // Distance behind the head (trail to the right of head)
-      if (distance > 0 && distance <= (int32_t)trailLength)
-      {
-        // Brightness diminishes linearly with distance
-        // brightness = 1000 - (distance * 1000 / trailLength) (in fixed point with 1000 scale)
-        uint32_t brightness = 1000 - ((uint32_t)distance * 1000 / trailLength);
-
-        buffer[i] = Color(headR, headG, headB) * (brightness / 1000.0f);
-      }
-    }
+    firstCommit = (firstCommit + 1) % MAX_COMMITS;
+    commitCount--;
   }
+}
 
-  // Render right-moving commit
-  if (commit.activeRight)
-  {
-    // headPos in fixed point
-    int32_t headPos = (int32_t)centerPos + (int32_t)commit.positionRight;
-    int headIndex = headPos / 1000; // Convert back to LED index
-
-    // Draw head
-    if (headIndex >= 0 && headIndex < static_cast<int>(numLEDs))
-      buffer[headIndex] = Color(headR, headG, headB);
-
-    // Draw trail
-    for (int i = numLEDs / 2; i < static_cast<int>(numLEDs); i++)
-    {
-      if (i == headIndex)
-        continue; // Skip head
-
-      // Distance in fixed point (multiply LED index by 1000 to match headPos scale)
-      int32_t distance = headPos - (i * 1000); // Distance behind the head (trail to the left of head)
-      if (distance > 0 && distance <= (int32_t)trailLength)
-      {
-        // Brightness diminishes linearly with distance
-        uint32_t brightness = 1000 - ((uint32_t)distance * 1000 / trailLength);
-
-        buffer[i] = Color(headR, headG, headB) * (brightness / 1000.0f);
-      }
-    }
-  }
-}
\ No newline at end of file
+const CommitEffect::Commit &CommitEffect::getCommit(uint8_t index) const
+{
+  return commits[(firstCommit + index) % MAX_COMMITS];
+}
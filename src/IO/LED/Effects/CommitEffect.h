@@ -1,7 +1,6 @@
 #pragma once
 
 #include "../Effects.h"
-#include <vector>
 
 class CommitEffect : public LEDEffect
 {
@@ -9,9 +8,11 @@ public:
   // Constructs the Commit effect.
   // Sends "commits" from the center of the strip to the edges with bright heads and fading trails
   CommitEffect(uint8_t priority = 0, bool transparent = false);
+  virtual ~CommitEffect();
 
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
   void NewFunction(uint16_t numLEDs, Color *buffer);
   virtual void onDisable() override;
 
@@ -32,23 +33,29 @@ public:
 private:
   bool active;
 
+  // Enough for a 1000 LED run at the default speed and a 500 ms interval.
+  // Beyond that the next commit waits until the oldest has left the strip,
+  // which stretches the interval, so a commit is never cut off early.
+  static const uint8_t MAX_COMMITS = 64;
+
   struct Commit
   {
-    uint32_t positionLeft;  // Position of commit moving left from center * 1000 (fixed point)
-    uint32_t positionRight; // Position of commit moving right from center * 1000 (fixed point)
-    uint32_t age;           // Age of the commit in milliseconds
-    bool activeLeft;        // Whether left commit is still active
-    bool activeRight;       // Whether right commit is still active
+    uint32_t position; // Distance both heads have moved from center * 1000 (fixed point)
+    uint32_t age;      // Age of the commit in milliseconds
   };
 
-  std::vector<Commit> commits;
+  // Ring of live commits, oldest first. All commits move at the same speed,
+  // so the oldest is always the first to leave the strip.
+  Commit *commits;
+  uint8_t firstCommit;
+  uint8_t commitCount;
   uint32_t timeSinceLastCommit;
-  unsigned long lastUpdateTime;
+  uint32_t pendingMicros; // frame time not yet applied, below 1 ms
 
   // Sync support
   bool syncEnabled;
 
   void spawnCommit();
   void updateCommits(uint32_t deltaTimeMillis, uint16_t numLEDs);
-  void renderCommit(const Commit &commit, LEDSegment *segment, Color *buffer);
+  const Commit &getCommit(uint8_t index) const; // 0 is the oldest
 };
\ No newline at end of file
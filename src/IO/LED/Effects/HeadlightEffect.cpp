@@ -1,30 +1,163 @@
 #include "HeadlightEffect.h"
 #include <cmath>
-#include <Arduino.h> // For millis()
+#include <Arduino.h>
+
+// Keyframes measure from either end of the segment, in halves of it or in
+// headlight sections (headlight_size, at most half the segment)
+enum HeadlightMeasure : uint8_t
+{
+  HALF,
+  SECTION,
+};
+
+// The first three tracks of every timeline are constants
+enum HeadlightTrack : uint8_t
+{
+  EDGE,
+  SECTION_END,
+  HALF_END,
+  MOVING, // the one animated edge of most timelines
+  STACK = MOVING,
+  GROUP_INNER,
+  GROUP_OUTER,
+  BRIGHT,
+};
+
+static const uint8_t HALF_BRIGHTNESS = 89; // 0.35
+
+static constexpr Keyframe EDGE_KEYS[] = {keyframe(0, 0.0f)};
+static constexpr Keyframe SECTION_END_KEYS[] = {keyframe(0, 1.0f, SECTION)};
+static constexpr Keyframe HALF_END_KEYS[] = {keyframe(0, 1.0f, HALF)};
+
+// Startup: groups of LEDs drop in from the edge at half brightness and pile
+// up from the inner end of the headlight section until it is full. After a
+// short delay it fills from the edge again at full brightness.
+static constexpr uint8_t STACK_STEPS = 11;     // groups to fill the section
+static constexpr uint16_t STACK_DROP_MS = 470; // a group crossing the whole section
+static constexpr int8_t STACK_GROUP_LEDS = 3;   // width of the falling group
+
+struct StackKeys
+{
+  Keyframe stack[STACK_STEPS];
+  Keyframe groupInner[2 * (STACK_STEPS - 1)];
+  Keyframe groupOuter[2 * (STACK_STEPS - 1)];
+  uint16_t done; // the last group has landed
+};
+
+static constexpr StackKeys stackKeys()
+{
+  StackKeys keys{};
+  keys.stack[0] = keyframe(0, 1.0f, SECTION);
+
+  uint16_t t = 0;
+  for (uint8_t k = 0; k < STACK_STEPS - 1; k++)
+  {
+    // Group k falls onto the k groups already there, the last one has no way to go
+    uint8_t free = STACK_STEPS - 1 - k;
+    uint16_t fall = (free * STACK_DROP_MS + STACK_STEPS / 2) / STACK_STEPS;
+    float landed = (float)free / STACK_STEPS;
+
+    keys.groupInner[2 * k] = keyframe(t, 0.0f, SECTION, 0, Ease::HOLD);
+    keys.groupInner[2 * k + 1] = keyframe(t + fall, landed, SECTION);
+    keys.groupOuter[2 * k] = keyframe(t, 0.0f, SECTION, STACK_GROUP_LEDS, Ease::HOLD);
+    keys.groupOuter[2 * k + 1] = keyframe(t + fall, landed, SECTION, STACK_GROUP_LEDS);
+
+    t += fall;
+    keys.stack[k + 1] = keyframe(t, landed, SECTION, 0, Ease::HOLD);
+  }
+
+  keys.done = t;
+  return keys;
+}
+
+static constexpr StackKeys STACK_KEYS = stackKeys();
+static constexpr uint16_t STARTUP_BRIGHT = STACK_KEYS.done + 200;
+
+static constexpr Keyframe BRIGHT_KEYS[] = {
+    keyframe(STARTUP_BRIGHT, 0.0f),
+    keyframe(STARTUP_BRIGHT + 1000, 1.0f, SECTION),
+};
+
+static constexpr Track STARTUP_TRACKS[] = {
+    track(EDGE_KEYS), track(SECTION_END_KEYS), track(HALF_END_KEYS), track(STACK_KEYS.stack),
+    track(STACK_KEYS.groupInner), track(STACK_KEYS.groupOuter), track(BRIGHT_KEYS),
+};
+static constexpr TimelineSpan STARTUP_SPANS[] = {
+    {0, STACK_KEYS.done, STACK, SECTION_END, HALF_BRIGHTNESS},
+    {0, STACK_KEYS.done, GROUP_INNER, GROUP_OUTER, HALF_BRIGHTNESS},
+    {STACK_KEYS.done, TIMELINE_FOREVER, EDGE, SECTION_END, HALF_BRIGHTNESS},
+    {STARTUP_BRIGHT, TIMELINE_FOREVER, EDGE, BRIGHT, 255},
+};
+static constexpr Timeline STARTUP = timeline(STARTUP_TRACKS, STARTUP_SPANS, STARTUP_BRIGHT + 1000, TimelineAnchor::ENDS);
+
+// Car on: the strip fills in from the headlight sections, in split mode only
+// the sections stay lit
+static constexpr Keyframe FILL_KEYS[] = {
+    keyframe(0, 1.0f, SECTION),
+    keyframe(1000, 1.0f, HALF, 0, Ease::SMOOTH),
+};
+static constexpr Track CAR_ON_TRACKS[] = {
+    track(EDGE_KEYS), track(SECTION_END_KEYS), track(HALF_END_KEYS), track(FILL_KEYS),
+};
+static constexpr TimelineSpan CAR_ON_SPANS[] = {{0, TIMELINE_FOREVER, EDGE, MOVING, 255}};
+static constexpr TimelineSpan CAR_ON_SPLIT_SPANS[] = {{0, TIMELINE_FOREVER, EDGE, SECTION_END, 255}};
+static constexpr Timeline CAR_ON = timeline(CAR_ON_TRACKS, CAR_ON_SPANS, 1000, TimelineAnchor::ENDS);
+static constexpr Timeline CAR_ON_SPLIT = timeline(CAR_ON_TRACKS, CAR_ON_SPLIT_SPANS, 0, TimelineAnchor::ENDS);
+
+// Split and join: the middle turns off from the center out, or back on from
+// the sections in. Both are symmetric so one can take over from the other.
+static constexpr Keyframe SPLIT_KEYS[] = {
+    keyframe(0, 1.0f, HALF),
+    keyframe(800, 1.0f, SECTION, 0, Ease::SMOOTH),
+};
+static constexpr Keyframe JOIN_KEYS[] = {
+    keyframe(0, 1.0f, SECTION),
+    keyframe(800, 1.0f, HALF, 0, Ease::SMOOTH),
+};
+static constexpr Track SPLIT_TRACKS[] = {
+    track(EDGE_KEYS), track(SECTION_END_KEYS), track(HALF_END_KEYS), track(SPLIT_KEYS),
+};
+static constexpr Track JOIN_TRACKS[] = {
+    track(EDGE_KEYS), track(SECTION_END_KEYS), track(HALF_END_KEYS), track(JOIN_KEYS),
+};
+static constexpr TimelineSpan SPLIT_SPANS[] = {
+    {0, TIMELINE_FOREVER, EDGE, MOVING, 255},
+    {0, 800, MOVING, HALF_END, 0},
+};
+static constexpr Timeline SPLIT = timeline(SPLIT_TRACKS, SPLIT_SPANS, 800, TimelineAnchor::ENDS);
+static constexpr Timeline JOIN = timeline(JOIN_TRACKS, SPLIT_SPANS, 800, TimelineAnchor::ENDS);
+
+// Turning off: the strip goes dark from the edges in, in split mode the
+// sections go dark from their inner end out
+static constexpr Keyframe OFF_KEYS[] = {
+    keyframe(0, 0.0f),
+    keyframe(1000, 1.0f, HALF, 0, Ease::SMOOTH),
+};
+static constexpr Keyframe OFF_SPLIT_KEYS[] = {
+    keyframe(0, 1.0f, SECTION),
+    keyframe(1000, 0.0f, SECTION, 0, Ease::SMOOTH),
+};
+static constexpr Track OFF_TRACKS[] = {
+    track(EDGE_KEYS), track(SECTION_END_KEYS), track(HALF_END_KEYS), track(OFF_KEYS),
+};
+static constexpr Track OFF_SPLIT_TRACKS[] = {
+    track(EDGE_KEYS), track(SECTION_END_KEYS), track(HALF_END_KEYS), track(OFF_SPLIT_KEYS),
+};
+static constexpr TimelineSpan OFF_SPANS[] = {
+    {0, TIMELINE_FOREVER, EDGE, MOVING, 0},
+    {0, TIMELINE_FOREVER, MOVING, HALF_END, 255},
+};
+static constexpr TimelineSpan OFF_SPLIT_SPANS[] = {
+    {0, TIMELINE_FOREVER, EDGE, MOVING, 255},
+    {0, TIMELINE_FOREVER, MOVING, HALF_END, 0},
+};
+static constexpr Timeline OFF = timeline(OFF_TRACKS, OFF_SPANS, 1000, TimelineAnchor::ENDS);
+static constexpr Timeline OFF_SPLIT = timeline(OFF_SPLIT_TRACKS, OFF_SPLIT_SPANS, 1000, TimelineAnchor::ENDS);
 
 HeadlightEffect::HeadlightEffect(uint8_t priority, bool transparent)
     : LEDEffect(priority, transparent),
       mode(HeadlightEffectMode::Off),
-      phase(-1),
-      phase_start(0),
-      T0(15.0f),          // 10 seconds for half brightness fill
-      T1(0.2f),           // 0.2 seconds delay
-      T2(1.0f),           // 1 second for full brightness fill
-      T10(1.0f),          // 1 second for full brightness fill
-      T20(1.0f),          // 1 second for full brightness fill
-      T13(0.8f),          // 0.8 seconds for transition from full to split
-      T14(0.8f),          // 0.8 seconds for transition from split to full
-      headlight_size(32), // 10 LEDs from each edge by default
-      ledsStepSize(3),    // Default to 1 LED at a time
-      phase_0_progress(0.0f),
-      phase_0_single_led_index(0),
-      phase_0_single_led_progress(0.0f),
-      phase_1_progress(0.0f),
-      phase_2_progress(0.0f),
-      phase_10_progress(0.0f),
-      phase_20_progress(0.0f),
-      phase_13_progress(0.0f),
-      phase_14_progress(0.0f),
+      headlight_size(32), // 32 LEDs from each edge by default
       red(false),
       blue(false),
       green(false),
@@ -34,16 +167,22 @@ HeadlightEffect::HeadlightEffect(uint8_t priority, bool transparent)
       hueCenter(0.0f), // Start with red
       hueEdge(240.0f), // End with blue
       hueOffset(0.0f),
-      rainbowSpeed(120.0f),
-      lastUpdate(0)
+      rainbowSpeed(120.0f)
 {
   name = "Headlight";
+  setLive(false);
+}
+
+void HeadlightEffect::play(const Timeline *timeline, uint16_t position)
+{
+  player.play(timeline, position);
+  setLive(timeline != nullptr);
 }
 
 bool HeadlightEffect::isActive()
 {
   // return active;
-  return mode != HeadlightEffectMode::Off && phase != -1;
+  return mode != HeadlightEffectMode::Off && player.getTimeline() != nullptr;
 }
 
 void HeadlightEffect::setOff()
@@ -52,16 +191,10 @@ void HeadlightEffect::setOff()
     return;
 
   if (mode == HeadlightEffectMode::CarOn)
-  {
-    phase = 20;
-    phase_start = millis(); // Record the starting time (ms)
-    phase_20_progress = 0.0f;
-  }
+    play(split ? &OFF_SPLIT : &OFF);
   else
-  {
-    phase = -1;
-    phase_start = 0;
-  }
+    play(nullptr);
+
   mode = HeadlightEffectMode::Off;
 }
 
@@ -71,14 +204,7 @@ void HeadlightEffect::setStartup()
     return;
 
   mode = HeadlightEffectMode::Startup;
-  phase = 0;
-  phase_start = millis(); // Record the starting time (ms)
-  phase_0_progress = 0.0f;
-  phase_0_single_led_index = 0;
-  phase_0_single_led_progress = 0.0f;
-  phase_0_start_single_led = 0;
-  phase_1_progress = 0.0f;
-  phase_2_progress = 0.0f;
+  play(&STARTUP);
 }
 
 void HeadlightEffect::setCarOn()
@@ -87,11 +213,7 @@ void HeadlightEffect::setCarOn()
     return;
 
   mode = HeadlightEffectMode::CarOn;
-  phase = 10;
-  phase_start = millis(); // Record the starting time (ms)
-  phase_10_progress = 0.0f;
-  phase_13_progress = 0.0f;
-  phase_14_progress = 0.0f;
+  play(split ? &CAR_ON_SPLIT : &CAR_ON);
 }
 
 void HeadlightEffect::setMode(HeadlightEffectMode mode)
@@ -126,25 +248,24 @@ void HeadlightEffect::setSplit(bool split)
 
   this->split = split;
 
-  // If we're in CarOn mode and in steady states, transition between them
-  if (mode == HeadlightEffectMode::CarOn)
+  if (mode != HeadlightEffectMode::CarOn)
+    return;
+
+  // Still filling in, split mode skips straight to the sections
+  if (player.isPlaying(&CAR_ON) && !player.isFinished())
   {
-    if (phase >= 11 && phase <= 14)
-    {
-      if (split) // Transition from full strip to split mode
-      {
-        phase = 13;
-        phase_start = millis();
-        phase_13_progress = 0.0f;
-      }
-      else if (!split) // Transition from split mode to full strip
-      {
-        phase = 14;
-        phase_start = millis();
-        phase_14_progress = 0.0f;
-      }
-    }
+    if (split)
+      play(&CAR_ON_SPLIT);
+    return;
   }
+
+  // Reversing a transition halfway picks up where the other one is
+  const Timeline *other = split ? &JOIN : &SPLIT;
+  uint16_t position = 0;
+  if (player.isPlaying(other) && !player.isFinished())
+    position = other->duration - player.getPosition();
+
+  play(split ? &SPLIT : &JOIN, position);
 }
 
 bool HeadlightEffect::getSplit()
@@ -166,143 +287,33 @@ void HeadlightEffect::getColor(bool &r, bool &g, bool &b)
   b = blue;
 }
 
-void HeadlightEffect::update(LEDSegment *segment)
+uint16_t HeadlightEffect::getTimelinePosition()
 {
-  // if (!active)
-  if (mode == HeadlightEffectMode::Off && phase == -1)
-    return;
-
-  unsigned long now = millis();
-  if (phase_start == 0)
-    phase_start = now;
-
-  uint16_t numLEDs = segment->getNumLEDs();
-  uint16_t numLEDsHalf = numLEDs / 2;
-  if (numLEDs % 2 == 1)
-    numLEDsHalf += 1;
-  uint16_t effective_size = std::min<uint16_t>(headlight_size, numLEDsHalf);
-
-  // Convert elapsed time from milliseconds to seconds.
-  float elapsed = (now - phase_start) / 1000.0f;
-
-  unsigned long dtMillis = now - lastUpdate;
-  float dtSeconds = dtMillis / 1000.0f;
-  lastUpdate = now;
-
-  // #########################################################
-  // mode == HeadlightEffectMode::Startup
-  // #########################################################
-
-  if (phase == 0) // Phase 0: Filling from outside at half brightness
-  {
-    if (phase_0_start_single_led == 0)
-    {
-      phase_0_start_single_led = now;
-    }
-
-    float T0_perLed = T0 / effective_size;
-    float elapsed_perLed = (now - phase_0_start_single_led) / 1000.0f;
-
-    phase_0_progress = std::min(elapsed / T0, 1.0f); // probaly not needed
-    phase_0_single_led_progress = std::min(elapsed_perLed / T0_perLed, 1.0f);
-
-    int single_led_to_light = static_cast<float>(effective_size) * phase_0_single_led_progress;
-
-    if (elapsed_perLed > T0_perLed || single_led_to_light >= (effective_size - phase_0_single_led_index) - ledsStepSize)
-    {
-      phase_0_single_led_index += ledsStepSize;
-      phase_0_start_single_led = now;
-    }
-
-    if (elapsed > T0 || phase_0_single_led_index >= effective_size)
-    {
-      phase = 1;
-      phase_start = now;
-    }
-  }
-  else if (phase == 1) // Phase 1: Delay
-  {
-    phase_1_progress = std::min(elapsed / T1, 1.0f);
-
-    if (elapsed > T1)
-    {
-      phase = 2;
-      phase_start = now;
-    }
-  }
-  else if (phase == 2) // Phase 2: Filling from outside at full brightness
-  {
-    phase_2_progress = std::min(elapsed / T2, 1.0f);
-
-    if (elapsed > T2)
-    {
-      phase = 3;
-      phase_start = now;
-    }
-  }
-  else if (phase == 3) // Phase 3: Final phase - all LEDs at full brightness
-  {
-    // do nothing
-  }
-
-  // #########################################################
-  // mode == HeadlightEffectMode::CarOn
-  // #########################################################
-  else if (phase == 10) // Phase 10: filling entire strip to full brightness
-  {
-    if (split)
-    {
-      phase = 12;
-      phase_start = now;
-    }
-
-    phase_10_progress = std::min(elapsed / T10, 1.0f);
+  return player.getPosition();
+}
 
-    if (elapsed > T10)
-    {
-      phase = 11;
-      phase_start = now;
-    }
-  }
-  else if (phase == 13) // Phase 13: Transition from full strip to split mode
-  {
-    phase_13_progress = std::min(elapsed / T13, 1.0f);
+void HeadlightEffect::setTimelinePosition(uint16_t position)
+{
+  player.setPosition(position);
+}
 
-    if (elapsed > T13)
-    {
-      phase = 12;
-      phase_start = now;
-    }
-  }
-  else if (phase == 14) // Phase 14: Transition from split mode to full strip
-  {
-    phase_14_progress = std::min(elapsed / T14, 1.0f);
+void HeadlightEffect::update(const FrameContext &frame)
+{
+  if (player.getTimeline() == nullptr)
+    return;
 
-    if (elapsed > T14)
-    {
-      phase = 11;
-      phase_start = now;
-    }
-  }
+  player.update(frame.ms());
 
-  // #########################################################
-  // mode == HeadlightEffectMode::TurningOff
-  // #########################################################
-  else if (phase == 20) // Phase 20: fade full white strip to off by starting from the edges and moving inward
+  // Faded out
+  if (mode == HeadlightEffectMode::Off && player.isFinished())
   {
-    phase_20_progress = std::min(elapsed / T20, 1.0f);
-
-    if (elapsed > T20)
-    {
-      phase = -1;
-      phase_start = now;
-      mode = HeadlightEffectMode::Off;
-    }
+    play(nullptr);
+    return;
   }
 
-  if (red && green && blue)
+  if (_isRainbow())
   {
-    hueOffset += rainbowSpeed * dtSeconds;
+    hueOffset += rainbowSpeed * frame.dtSeconds();
     // Wrap hueOffset to the range [0, 360)
     hueOffset = fmod(hueOffset, 360.0f);
 
@@ -319,322 +330,70 @@ void HeadlightEffect::update(LEDSegment *segment)
 
 void HeadlightEffect::render(LEDSegment *segment, Color *buffer)
 {
-  // if (!active)
-  if (mode == HeadlightEffectMode::Off && phase == -1)
+  const Timeline *timeline = player.getTimeline();
+  if (timeline == nullptr)
     return;
 
-  // Define colors
-
-  float halfBrightness = 0.35f; // Half brightness version
-
   uint16_t numLEDs = segment->getNumLEDs();
-  uint16_t numLEDsHalf = numLEDs / 2;
-  if (numLEDs % 2 == 1)
-    numLEDsHalf += 1;
-  uint16_t effective_size = std::min<uint16_t>(headlight_size, numLEDsHalf);
-
-  // For each phase, calculate which LEDs should be lit and at what brightness
-  if (phase == 0) // Phase 0: Filling from outside at half brightness
-  {
-    int leds = floor(phase_0_progress * effective_size);
+  uint16_t numLEDsHalf = (numLEDs + 1) / 2;
+  const uint16_t measures[] = {numLEDsHalf, std::min<uint16_t>(headlight_size, numLEDsHalf)};
 
-    int single_led_to_light = static_cast<float>(effective_size) * phase_0_single_led_progress;
+  TimelineRun runs[TIMELINE_MAX_SPANS];
+  uint8_t count = player.resolve(measures, numLEDs, runs);
 
-    // Fill left side from the edge inward
-    if (phase_0_single_led_index > 1)
-    {
-      for (int i = 0; i < phase_0_single_led_index; i++)
-      {
-        buffer[effective_size - i - 1] = _getColor(segment, effective_size - i - 1, numLEDsHalf) * halfBrightness;
-        buffer[numLEDs - 1 - (effective_size - i - 1)] = buffer[effective_size - i - 1];
-      }
-    }
+  Color color = _getColor();
+  bool rainbow = _isRainbow();
 
-    // Highlight the current LED being filled
-    for (int i = 0; i < ledsStepSize; i++)
-    {
-      int ledIndex = single_led_to_light + i;
-      if (ledIndex < effective_size)
-      {
-        buffer[ledIndex] = _getColor(segment, ledIndex, numLEDsHalf) * halfBrightness;
-        buffer[numLEDs - 1 - ledIndex] = buffer[ledIndex];
-      }
-    }
-  }
-  else if (phase == 1) // Phase 1: Delay
-  {
-    // fill with half brightness
-    for (int i = 0; i < effective_size; i++)
-    {
-      buffer[i] = _getColor(segment, i, numLEDsHalf) * halfBrightness;
-      buffer[numLEDs - 1 - i] = buffer[i];
-    }
-  }
-  else if (phase == 2) // Phase 2: Filling from outside at full brightness
-  {
-    // First, set all LEDs that should be at half brightness
-    for (int i = 0; i < effective_size; i++)
-    {
-      buffer[i] = _getColor(segment, i, numLEDsHalf) * halfBrightness; // Left side
-      buffer[numLEDs - 1 - i] = buffer[i];                           // Right side
-    }
-
-    // Then, set LEDs that should be at full brightness based on progress
-    int leftLeds = floor(phase_2_progress * effective_size);
-    int rightLeds = floor(phase_2_progress * effective_size);
-
-    // Fill left side from the edge inward with full brightness
-    for (int i = 0; i < leftLeds; i++)
-    {
-      buffer[i] = _getColor(segment, i, numLEDsHalf);
-    }
-
-    // Fill right side from the edge inward with full brightness
-    for (int i = 0; i < rightLeds; i++)
-    {
-      buffer[numLEDs - 1 - i] = buffer[i];
-    }
-  }
-  else if (phase == 3) // Final phase - all LEDs at full brightness
-  {
-    // Set all headlight LEDs to full brightness
-    for (int i = 0; i < effective_size; i++)
-    {
-      buffer[i] = _getColor(segment, i, numLEDsHalf); // Left side
-      buffer[numLEDs - 1 - i] = buffer[i];          // Right side
-    }
-  }
-
-  // #########################################################
-  // mode == HeadlightEffectMode::CarOn
-  // #########################################################
-  else if (phase == 10) // Phase 10: filling entire strip to full brightness
-  {
-    int ledsToAnimate = numLEDs - effective_size * 2;
-    int ledsToAnimateSide = ledsToAnimate / 2;
-
-    float p = phase_10_progress;
-    p = 3 * p * p - 2 * p * p * p;
-
-    for (int i = 0; i < numLEDs; i++)
-    {
-      if (i <= effective_size)
-        buffer[i] = _getColor(segment, i, numLEDsHalf); // Left side
-
-      if (i >= numLEDs - effective_size - 1)
-        buffer[i] = buffer[numLEDs - 1 - i];
-
-      if (i > effective_size && i < effective_size + (ledsToAnimateSide * p))
-        buffer[i] = _getColor(segment, i, numLEDsHalf);
-
-      if (i > numLEDs - effective_size - ledsToAnimateSide && i > numLEDs - effective_size - (ledsToAnimateSide * p))
-        buffer[i] = buffer[numLEDs - 1 - i];
-    }
-  }
-  else if (phase == 11) // full strip full brightness
-  {
-    for (int i = 0; i < numLEDsHalf; i++)
-    {
-      buffer[i] = _getColor(segment, i, numLEDsHalf);
-      buffer[numLEDs - 1 - i] = buffer[i];
-    }
-  }
-  else if (phase == 12) // split strip full brightness
-  {
-    for (int i = 0; i < effective_size; i++)
-    {
-      buffer[i] = _getColor(segment, i, numLEDsHalf);
-      buffer[numLEDs - 1 - i] = buffer[i];
-    }
-  }
-  else if (phase == 13) // Transition from full strip to split mode
+  for (uint8_t r = 0; r < count; r++)
   {
-    // Animate turning off middle section
-    int middleLength = numLEDsHalf - effective_size;
-
-    float p = phase_13_progress;
-    p = 3 * p * p - 2 * p * p * p; // Smooth step
-
-    int ledsToTurnOff = middleLength * p;
-
-    // Handle left half of the strip
-    for (int i = 0; i < numLEDsHalf; i++)
+    const TimelineRun &run = runs[r];
+    if (!rainbow || run.level == 0)
     {
-      if (i < effective_size)
-      {
-        // Keep headlight section on
-        buffer[i] = _getColor(segment, i, numLEDsHalf);
-      }
-      else if (i >= numLEDsHalf - ledsToTurnOff)
-      {
-        // Turn off middle section progressively from center outward
-        buffer[i] = Color(0, 0, 0);
-      }
-      else
-      {
-        // Keep remaining middle section on until its turn
-        buffer[i] = _getColor(segment, i, numLEDsHalf);
-      }
-
-      // Mirror to right side
-      buffer[numLEDs - 1 - i] = buffer[i];
+      TimelinePlayer::fill(buffer, numLEDs, timeline->anchor, run, color);
+      continue;
     }
-  }
-  else if (phase == 14) // Transition from split mode to full strip
-  {
-    // Animate turning on middle section
-    int middleLength = numLEDsHalf - effective_size;
-
-    float p = phase_14_progress;
-    p = 3 * p * p - 2 * p * p * p; // Smooth step
 
-    int ledsToTurnOn = middleLength * p;
+    // Rainbow: the hue runs from the center hue at the edge towards the
+    // edge hue at the middle, linear in the distance from the edge
+    float diff = hueEdge - hueCenter;
+    if (diff < 0)
+      diff += 360.0f;
+    float hueStep = diff / numLEDsHalf;
 
-    // Handle left half of the strip
-    for (int i = 0; i < numLEDsHalf; i++)
-    {
-      if (i < effective_size)
-      {
-        // Keep headlight section on
-        buffer[i] = _getColor(segment, i, numLEDsHalf);
-      }
-      else if (i < effective_size + ledsToTurnOn)
-      {
-        // Turn on middle section progressively from headlight outward
-        buffer[i] = _getColor(segment, i, numLEDsHalf);
-      }
-      else
-      {
-        // Keep remaining middle section off until its turn
-        buffer[i] = Color(0, 0, 0);
-      }
-
-      // Mirror to right side
+    Color::hsv2rgbSpan(buffer + run.start, run.end - run.start, Color::hue32(hueCenter - hueStep * run.start),
+                       -(int32_t)Color::hue32(hueStep), 255, run.level);
+    for (uint16_t i = run.start; i < run.end; i++)
       buffer[numLEDs - 1 - i] = buffer[i];
-    }
-  }
-
-  // #########################################################
-  // mode == HeadlightEffectMode::TurningOff
-  // #########################################################
-  else if (phase == 20)
-  { // Phase 20: fade full white strip to off by starting
-
-    float p = phase_20_progress;
-    p = 3 * p * p - 2 * p * p * p;
-
-    if (split)
-    {
-      // Only fade the headlight sections (effective_size LEDs from each edge)
-      // Animation goes from inside out when split is true
-      int ledsOffPerSide = effective_size * p;
-
-      for (int i = 0; i < numLEDs; i++)
-      {
-        // Left side headlight section
-        if (i < effective_size)
-        {
-          // Turn off LEDs from inside out: start at (effective_size - 1) and work towards 0
-          if (i >= effective_size - ledsOffPerSide)
-          {
-            buffer[i] = Color(0, 0, 0);
-          }
-          else
-          {
-            buffer[i] = _getColor(segment, i, numLEDsHalf);
-          }
-        }
-        // Right side headlight section
-        else if (i >= numLEDs - effective_size)
-        {
-          // Turn off LEDs from inside out: start at (numLEDs - effective_size) and work towards end
-          if (i < numLEDs - effective_size + ledsOffPerSide)
-          {
-            buffer[i] = Color(0, 0, 0);
-          }
-          else
-          {
-            buffer[i] = _getColor(segment, i, numLEDsHalf);
-          }
-        }
-        // Middle section remains off when split is true
-        else
-        {
-          buffer[i] = Color(0, 0, 0);
-        }
-      }
-    }
-    else
-    {
-      // Original behavior: fade entire strip from edges
-      int ledsPerSide = numLEDsHalf;
-      int ledsOffPerSide = ledsPerSide * p;
-
-      for (int i = 0; i < numLEDsHalf; i++)
-      {
-        // If the LED is within the off-section on either side, turn it off.
-        if (i < ledsOffPerSide)
-        {
-          buffer[i] = Color(0, 0, 0);
-          buffer[numLEDs - 1 - i] = buffer[i];
-        }
-        else
-        {
-          buffer[i] = _getColor(segment, i, numLEDsHalf);
-          buffer[numLEDs - 1 - i] = buffer[i];
-        }
-      }
-    }
-  }
-  else if (phase == -1) // full strip off
-  {
-    for (int i = 0; i < numLEDs; i++)
-    {
-      buffer[i] = Color(0, 0, 0);
-    }
   }
 }
 
-Color HeadlightEffect::_getColor(LEDSegment *segment, int i, int size)
+Coverage HeadlightEffect::getCoverage(LEDSegment *segment)
 {
-  Color color;
-  color.r = red ? 255 : 0;
-  color.g = green ? 255 : 0;
-  color.b = blue ? 255 : 0;
+  if (player.getTimeline() == nullptr)
+    return Coverage{Coverage::NONE, false};
 
-  bool rainbow = false;
-  if (color == Color(255, 255, 255))
-    rainbow = true;
-
-  if (color == Color(0, 0, 0))
-    color = Color(255, 255, 255);
-
-  uint16_t numLEDs = segment->getNumLEDs();
-
-  if (rainbow)
-  {
-    float normDist = (float)i / size; // 0 at edge, 1 at center
+  // Filled in or joined up, the whole segment is lit
+  if ((player.isPlaying(&CAR_ON) || player.isPlaying(&JOIN)) && player.isFinished())
+    return Coverage{Coverage::FULL, true};
+  return Coverage{Coverage::SPANS, true};
+}
 
-    float diff = hueEdge - hueCenter;
-    if (diff < 0)
-    {
-      diff += 360.0f;
-    }
-    // Linearly interpolate along the positive direction.
-    float hue = hueCenter - diff * normDist;
+bool HeadlightEffect::_isRainbow()
+{
+  return red && green && blue;
+}
 
-    // Normalize the hue to the [0, 360) range.
-    hue = fmod(hue, 360.0f);
-    if (hue < 0)
-      hue += 360.0f;
+Color HeadlightEffect::_getColor()
+{
+  // No colour selected is white
+  if (!red && !green && !blue)
+    return Color(255, 255, 255);
 
-    return Color::hsv2rgb(hue, 1.0f, 1.0f);
-  }
-  return color;
+  return Color(red ? 255 : 0, green ? 255 : 0, blue ? 255 : 0);
 }
 
 void HeadlightEffect::onDisable()
 {
-  phase = -1;
   mode = HeadlightEffectMode::Off;
-}
\ No newline at end of file
+  play(nullptr);
+}
@@ -12,6 +12,7 @@ IndicatorEffect::IndicatorEffect(Side side, uint8_t priority, bool transparent)
       fadeInTime(250)
 {
   name = "Indicator";
+  setLive(false);
   bigIndicator = false;
   activatedTime = 0;
   otherIndicator = nullptr;
@@ -48,7 +49,8 @@ void IndicatorEffect::setActive(bool active)
 
   if (active)
   {
-    onTime = millis();
+    setLive(true);
+    onTime = getFrame().ms();
     blinkCycle = 3000;
     // If another indicator exists and is active, sync start times.
     if (otherIndicator != nullptr && otherIndicator->isActive())
@@ -59,7 +61,7 @@ void IndicatorEffect::setActive(bool active)
     {
       // Otherwise, simply set this activatedTime.
     }
-    activatedTime = millis();
+    activatedTime = getFrame().ms();
   }
   else
   {
@@ -67,13 +69,13 @@ void IndicatorEffect::setActive(bool active)
     fadeFactor = 0.0f;
     activatedTime = 0;
 
-    if (millis() - onTime > 1000)
+    if (getFrame().ms() - onTime > 1000)
     {
       onTime = 0;
     }
     else
     {
-      onTime = millis();
+      onTime = getFrame().ms();
     }
 
     if (synced == true)
@@ -102,16 +104,17 @@ void IndicatorEffect::syncWithOtherIndicator()
   otherIndicator->synced = true;
 }
 
-void IndicatorEffect::update(LEDSegment *segment)
+void IndicatorEffect::update(const FrameContext &frame)
 {
   if (!indicatorActive && onTime == 0)
   {
     // Ensure fade factor remains 0 if not active.
     fadeFactor = 0.0f;
+    setLive(false);
     return;
   }
   // Compute where we are within the blink cycle.
-  uint64_t currentTime = millis();
+  uint64_t currentTime = frame.ms();
   currentTime -= activatedTime;
   uint64_t timeInCycle = currentTime % blinkCycle;
 
@@ -136,7 +139,7 @@ void IndicatorEffect::update(LEDSegment *segment)
       }
       else if (!synced)
       {
-        activatedTime = millis() - 600;
+        activatedTime = frame.ms() - 600;
       }
     }
   }
@@ -148,24 +151,29 @@ void IndicatorEffect::render(LEDSegment *segment, Color *buffer)
   if (!indicatorActive && onTime == 0)
     return;
 
-  if (millis() - onTime > blockTime)
+  if (getFrame().ms() - onTime > blockTime)
   {
     onTime = 0;
   }
 
-  uint16_t regionLength = 32;
+  int region = 32;
 
   if (bigIndicator)
   {
-    regionLength = (segment->getNumLEDs() / 2) - regionLength;
+    region = (segment->getNumLEDs() / 2) - region;
   }
 
-  if (regionLength <= 1)
+  // Segments shorter than the region are lit whole instead of overrun
+  region = std::min<int>(region, segment->getNumLEDs());
+
+  if (region <= 1)
   {
     // Handle error or simply return
     return;
   }
 
+  uint16_t regionLength = region;
+
   if (onTime > 0 && !indicatorActive)
   {
     for (uint16_t i = 0; i < regionLength; i++)
@@ -207,15 +215,13 @@ void IndicatorEffect::render(LEDSegment *segment, Color *buffer)
 
     finalFactor = constrain(finalFactor, 0.0f, 1.0f);
 
-    // Compute final color for this LED.
-    uint8_t r = baseR * finalFactor;
-    uint8_t g = baseG * finalFactor;
-    uint8_t b = baseB * finalFactor;
+    // Compute final color for this LED. The fade is the alpha, so the layer
+    // below (e.g. the taillight) shows through while the LED lights up.
+    Color color(baseR, baseG, baseB, 255 * finalFactor);
 
     // if (i == 0) // Debugging
     // {
     //   Serial.println("fadeFactor: " + String(fadeFactor) + " d: " + String(d) + " finalFactor: " + String(finalFactor));
-    //   Serial.println("i: " + String(i) + " r: " + String(r) + " g: " + String(g) + " b: " + String(b));
     // }
 
     // Set the color in the buffer.
@@ -224,27 +230,34 @@ void IndicatorEffect::render(LEDSegment *segment, Color *buffer)
     {
       if (side == LEFT)
       {
-        buffer[i] = Color(r, g, b);
+        setPixel(buffer, i, color);
       }
       else
       {
-        buffer[segment->getNumLEDs() - i - 1] = Color(r, g, b);
+        setPixel(buffer, segment->getNumLEDs() - i - 1, color);
       }
     }
     else
     {
       if (side == LEFT)
       {
-        buffer[segment->getNumLEDs() / 2 - regionLength + i] = Color(r, g, b);
+        setPixel(buffer, segment->getNumLEDs() / 2 - regionLength + i, color);
       }
       else
       {
-        buffer[segment->getNumLEDs() / 2 + regionLength - i - 1] = Color(r, g, b);
+        setPixel(buffer, segment->getNumLEDs() / 2 + regionLength - i - 1, color);
       }
     }
   }
 }
 
+Coverage IndicatorEffect::getCoverage(LEDSegment *segment)
+{
+  if (!indicatorActive && onTime == 0)
+    return Coverage{Coverage::NONE, false};
+  return Coverage{Coverage::SPANS, false};
+}
+
 void IndicatorEffect::onDisable()
 {
   indicatorActive = false;
@@ -20,8 +20,9 @@ public:
   // All timing and color parameters are customizable.
   IndicatorEffect(Side side, uint8_t priority = 1, bool transparent = false);
 
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
   virtual void onDisable() override;
 
   void setOtherIndicator(IndicatorEffect *otherIndicator);
@@ -1,5 +1,6 @@
 #include "NightRiderEffect.h"
 #include <cmath>
+#include <algorithm>
 
 NightRiderEffect::NightRiderEffect(uint8_t priority, bool transparent)
     : LEDEffect(priority, transparent),
@@ -8,10 +9,11 @@ NightRiderEffect::NightRiderEffect(uint8_t priority, bool transparent)
       tailLength(15.0f),
       progress(0.0f),
       forward(true),
-      lastUpdateTime(0),
-      syncEnabled(true) // Enable sync by default
+      syncEnabled(true), // Enable sync by default
+      field(LayoutAxis::ACROSS)
 {
   name = "NightRider";
+  setLive(false);
 }
 
 void NightRiderEffect::setActive(bool _active)
@@ -20,13 +22,13 @@ void NightRiderEffect::setActive(bool _active)
     return;
 
   active = _active;
+  setLive(active);
 
   if (active)
   {
     // Reset the progress and direction.
     progress = 0.0f;
     forward = true;
-    lastUpdateTime = SyncManager::syncMillis();
   }
   else
   {
@@ -41,6 +43,7 @@ bool NightRiderEffect::isActive() const
 void NightRiderEffect::setSyncData(NightRiderSyncData syncData)
 {
   active = syncData.active;
+  setLive(active);
   cycleTime = syncData.cycleTime;
   tailLength = syncData.tailLength;
   progress = syncData.progress;
@@ -58,22 +61,12 @@ NightRiderSyncData NightRiderEffect::getSyncData()
   };
 }
 
-void NightRiderEffect::update(LEDSegment *segment)
+void NightRiderEffect::update(const FrameContext &frame)
 {
   if (!active)
     return;
 
-  unsigned long currentTime = SyncManager::syncMillis();
-  if (lastUpdateTime == 0)
-  {
-    lastUpdateTime = currentTime;
-    return;
-  }
-
-  // Calculate elapsed time in seconds.
-  unsigned long dtMillis = currentTime - lastUpdateTime;
-  float dtSeconds = dtMillis / 1000.0f;
-  lastUpdateTime = currentTime;
+  float dtSeconds = frame.dtSeconds();
 
   if (cycleTime <= 0.0f)
     return;
@@ -115,6 +108,10 @@ void NightRiderEffect::render(LEDSegment *segment, Color *buffer)
   if (numLEDs < 2)
     return;
 
+  if (field.render(segment, buffer, [this](const uint16_t *coords, uint16_t count, Color *colors)
+                   { renderField(coords, count, colors); }))
+    return;
+
   // Clear the buffer (turn off all LEDs).
   for (uint16_t i = 0; i < numLEDs; i++)
   {
@@ -163,7 +160,35 @@ void NightRiderEffect::render(LEDSegment *segment, Color *buffer)
   }
 }
 
+// Same head and linear tail as by index, with the tail measured in LEDs of
+// the longest segment
+void NightRiderEffect::renderField(const uint16_t *coords, uint16_t count, Color *colors)
+{
+  int32_t head = progress * LAYOUT_ONE;
+  int32_t tail = std::max<int32_t>(1, tailLength / getMaxSegmentLength() * LAYOUT_ONE);
+
+  for (uint16_t i = 0; i < count; i++)
+  {
+    int32_t distance = abs((int32_t)coords[i] - head);
+    uint8_t red = distance < tail ? 255 * (tail - distance) / tail : 0;
+    colors[i] = Color(red, 0, 0);
+  }
+}
+
+Coverage NightRiderEffect::getCoverage(LEDSegment *segment)
+{
+  if (!active || segment->getNumLEDs() < 2)
+    return Coverage{Coverage::NONE, false};
+  return Coverage{Coverage::FULL, true};
+}
+
+bool NightRiderEffect::drawsByPosition(const LEDSegment *segment) const
+{
+  return field.renders(segment);
+}
+
 void NightRiderEffect::onDisable()
 {
   active = false;
+  setLive(false);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Effects.h"
+#include "../LEDLayout.h"
 
 class NightRiderEffect : public LEDEffect
 {
@@ -10,8 +11,10 @@ public:
   // tailLength: tail length in LED units (should be > 0).
   NightRiderEffect(uint8_t priority = 0, bool transparent = false);
 
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
+  virtual bool drawsByPosition(const LEDSegment *segment) const override;
   virtual void onDisable() override;
 
   // Activate or disable the effect.
@@ -32,9 +35,11 @@ private:
   float progress;
   // Direction of movement: true = moving forward, false = moving backward.
   bool forward;
-  // Last update time (in milliseconds).
-  unsigned long lastUpdateTime;
 
   // Sync support
   bool syncEnabled;
+
+  // Placed segments show one sweep across the car
+  LayoutField field;
+  void renderField(const uint16_t *coords, uint16_t count, Color *colors);
 };
@@ -1,28 +1,33 @@
 #include "PoliceEffect.h"
 #include <Arduino.h>
-#include <math.h>
 
-// Helper function: Easing function for smoother transitions
-static float easeInOut(float t)
-{
-  return 0.5f * (1.0f - cosf(t * PI));
-}
+// Red on the left, blue on the right
+static constexpr FlashStep SLOW_STEPS[] = {
+    {1, 0, FlashColor::PRIMARY, FlashColor::BLACK},
+    {1, 0, FlashColor::BLACK, FlashColor::SECONDARY},
+};
+
+// A burst of flashes on one side, then on the other
+static constexpr FlashStep FAST_STEPS[] = {
+    {1, FLASHES_CONFIGURED, FlashColor::PRIMARY, FlashColor::BLACK},
+    {1, FLASHES_CONFIGURED, FlashColor::BLACK, FlashColor::SECONDARY},
+};
+
+static constexpr FlashPattern SLOW_PATTERN = flashPattern(SLOW_STEPS);
+static constexpr FlashPattern FAST_PATTERN = flashPattern(FAST_STEPS);
 
 PoliceEffect::PoliceEffect(uint8_t priority, bool transparent)
     : LEDEffect(priority, transparent),
       active(false),
       mode(PoliceMode::FAST),
-      lastUpdateTime(0),
-      flashProgress(0.0f),
-      cycleProgress(0.0f),
       fastSpeed(0.5f),            // 0.5 seconds per full flash cycle in fast mode
       slowSpeed(1.0f),            // 1.0 seconds per full flash cycle in slow mode
       fastModeFlashesPerCycle(3), // 3 flashes per color cycle
       blueColor(Color(0, 0, 255)),
-      redColor(Color(255, 0, 0)),
-      currentFlash(0)
+      redColor(Color(255, 0, 0))
 {
   name = "Police";
+  setLive(false);
 }
 
 void PoliceEffect::setActive(bool a)
@@ -31,13 +36,11 @@ void PoliceEffect::setActive(bool a)
     return;
 
   active = a;
+  setLive(active);
   if (active)
   {
     // Reset animation state when activating
-    lastUpdateTime = millis();
-    flashProgress = 0.0f;
-    cycleProgress = 0.0f;
-    currentFlash = 0;
+    sequencer.reset();
   }
 }
 
@@ -49,10 +52,9 @@ bool PoliceEffect::isActive() const
 void PoliceEffect::setSyncData(PoliceSyncData syncData)
 {
   active = syncData.active;
+  setLive(active);
   mode = syncData.mode;
-  flashProgress = syncData.flashProgress;
-  cycleProgress = syncData.cycleProgress;
-  currentFlash = syncData.currentFlash;
+  sequencer.setState(syncData.step, syncData.beat);
 }
 
 PoliceSyncData PoliceEffect::getSyncData()
@@ -60,9 +62,8 @@ PoliceSyncData PoliceEffect::getSyncData()
   return PoliceSyncData{
       .active = active,
       .mode = mode,
-      .flashProgress = flashProgress,
-      .cycleProgress = cycleProgress,
-      .currentFlash = currentFlash};
+      .step = sequencer.getStep(),
+      .beat = sequencer.getBeat()};
 }
 
 void PoliceEffect::setMode(PoliceMode m)
@@ -75,56 +76,25 @@ PoliceMode PoliceEffect::getMode() const
   return mode;
 }
 
-void PoliceEffect::update(LEDSegment *segment)
+const FlashPattern &PoliceEffect::getPattern() const
 {
-  if (!active)
-    return;
+  return mode == PoliceMode::FAST ? FAST_PATTERN : SLOW_PATTERN;
+}
 
-  unsigned long currentTime = millis();
+float PoliceEffect::getBeatSeconds() const
+{
+  // A slow cycle is two steps. A fast flash is one lit and one dark beat.
+  if (mode == PoliceMode::FAST)
+    return fastSpeed / fastModeFlashesPerCycle / 2.0f;
+  return slowSpeed / 2.0f;
+}
 
-  // First update - initialize time
-  if (lastUpdateTime == 0)
-  {
-    lastUpdateTime = currentTime;
+void PoliceEffect::update(const FrameContext &frame)
+{
+  if (!active)
     return;
-  }
 
-  // Calculate the elapsed time in seconds
-  float deltaTime = (currentTime - lastUpdateTime) / 1000.0f;
-  lastUpdateTime = currentTime;
-
-  // Determine the speed based on the current mode
-  float cycleDuration = (mode == PoliceMode::FAST) ? fastSpeed : slowSpeed;
-
-  if (mode == PoliceMode::SLOW)
-  {
-    // In slow mode, simple toggle between colors
-    cycleProgress += deltaTime / cycleDuration;
-    if (cycleProgress >= 1.0f)
-    {
-      cycleProgress = 0.0f;
-    }
-  }
-  else if (mode == PoliceMode::FAST)
-  {
-    // Update the flash progress (controls the on/off of each flash)
-    // Each flash consists of an on state and an off state (complete cycle)
-    flashProgress += deltaTime / (cycleDuration / fastModeFlashesPerCycle);
-    if (flashProgress >= 1.0f)
-    {
-      flashProgress = 0.0f;
-
-      // Move to the next flash
-      currentFlash++;
-
-      // After flashesPerCycle flashes, switch sides
-      if (currentFlash >= fastModeFlashesPerCycle)
-      {
-        currentFlash = 0;
-        cycleProgress = (cycleProgress < 0.5f) ? 0.5f : 0.0f;
-      }
-    }
-  }
+  sequencer.update(getPattern(), frame.dtSeconds(), getBeatSeconds(), fastModeFlashesPerCycle);
 }
 
 void PoliceEffect::render(LEDSegment *segment, Color *buffer)
@@ -132,66 +102,17 @@ void PoliceEffect::render(LEDSegment *segment, Color *buffer)
   if (!active)
     return;
 
-  uint16_t numLEDs = segment->getNumLEDs();
-  uint16_t half = numLEDs / 2;
+  sequencer.render(getPattern(), buffer, segment->getNumLEDs(), redColor, blueColor);
+}
 
-  if (mode == PoliceMode::SLOW)
-  {
-    // In SLOW mode: alternate between colors on each side with no fade
-    bool isRed = cycleProgress < 0.5f;
-
-    for (uint16_t i = 0; i < numLEDs; i++)
-    {
-      if (i < half) // Left side
-      {
-        buffer[i] = isRed ? redColor : Color();
-      }
-      else // Right side
-      {
-        buffer[i] = isRed ? Color() : blueColor;
-      }
-    }
-  }
-  else // FAST mode
-  {
-    // In FAST mode: flash one side for fastModeFlashesPerCycle times, then the other side
-    bool isRedCycle = cycleProgress < 0.5f;
-
-    // Flash intensity based on flash progress
-    // 0-0.5: On, 0.5-1.0: Off
-    float flashIntensity = (flashProgress < 0.5f) ? 1.0f : 0.0f;
-
-    for (uint16_t i = 0; i < numLEDs; i++)
-    {
-      if (isRedCycle)
-      {
-        // Red on left side
-        if (i < half)
-        {
-          buffer[i] = redColor * flashIntensity;
-        }
-        else
-        {
-          buffer[i] = Color(0, 0, 0); // Right side off during red cycle
-        }
-      }
-      else
-      {
-        // Blue on right side
-        if (i >= half)
-        {
-          buffer[i] = blueColor * flashIntensity;
-        }
-        else
-        {
-          buffer[i] = Color(0, 0, 0); // Left side off during blue cycle
-        }
-      }
-    }
-  }
+Coverage PoliceEffect::getCoverage(LEDSegment *segment)
+{
+  // Both halves are written every frame, off ones black
+  return active ? Coverage{Coverage::FULL, true} : Coverage{Coverage::NONE, false};
 }
 
 void PoliceEffect::onDisable()
 {
   active = false;
+  setLive(false);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Effects.h"
+#include "../FlashPattern.h"
 #include <stdint.h>
 
 class PoliceEffect : public LEDEffect
@@ -9,8 +10,9 @@ public:
   // Constructs the police light effect
   PoliceEffect(uint8_t priority = 0, bool transparent = false);
 
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
   virtual void onDisable() override;
 
   // Activate or disable the effect
@@ -28,11 +30,7 @@ private:
   bool active;
   PoliceMode mode;
 
-  // Animation parameters
-  unsigned long lastUpdateTime;
-  float flashProgress;   // Tracks the current position in the flash cycle (0-1)
-  float cycleProgress;   // Tracks which color is currently displayed
-  uint16_t currentFlash; // Tracks the current flash count in FAST mode
+  FlashSequencer sequencer;
 
   // Configuration parameters
   float fastSpeed;                  // Flash cycle speed in seconds (fast mode)
@@ -42,4 +40,7 @@ private:
   // Colors
   Color blueColor;
   Color redColor;
+
+  const FlashPattern &getPattern() const;
+  float getBeatSeconds() const;
 };
\ No newline at end of file
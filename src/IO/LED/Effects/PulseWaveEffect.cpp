@@ -1,31 +1,30 @@
 #include "PulseWaveEffect.h"
 #include <cmath>
 #include "../LEDStrip.h"
+#include "../Wave.h"
 
 PulseWaveEffect::PulseWaveEffect(uint8_t priority, bool transparent)
     : LEDEffect(priority, transparent),
       active(false),
-      lastUpdateTime(0),
-      phase(0.0f),
-      colorPhase(0.0f),
+      phase(0),
+      colorPhase(0),
       baseHue(140.0f),        // Start with a blue-green base
       hueRange(120.0f),       // Cover 120 degrees of the color wheel
       waveSpeed(0.5f),        // Half a cycle per second
       pulseFrequency(2.0f),   // Two wave peaks across the strip
       colorCycleSpeed(20.0f), // 20 degrees per second (full color cycle in 18 seconds)
       colorSaturation(1.0f),  // Full saturation
-      intensity(1.0f)         // Full brightness
+      intensity(1.0f),        // Full brightness
+      field(LayoutAxis::AROUND)
 {
   name = "PulseWave";
+  setLive(false);
 }
 
 void PulseWaveEffect::setActive(bool _active)
 {
   active = _active;
-  if (active && lastUpdateTime == 0)
-  {
-    lastUpdateTime = millis();
-  }
+  setLive(active);
 }
 
 bool PulseWaveEffect::isActive() const
@@ -33,110 +32,117 @@ bool PulseWaveEffect::isActive() const
   return active;
 }
 
-float PulseWaveEffect::computeWave(float pos, float phase, float frequency)
+void PulseWaveEffect::update(const FrameContext &frame)
 {
-  // Creates a smooth sinusoidal wave that varies from 0 to 1
-  // pos: position along the strip [0, 1]
-  // phase: current animation phase [0, 2π]
-  // frequency: number of wave cycles across the strip
+  if (!active)
+    return;
 
-  // Calculate the wave pattern
-  // Use negative phase to make waves move away from index 0 (or center in mirrored mode)
-  float value = 0.5f * (1.0f + sinf(2.0f * PI * (frequency * pos - phase)));
+  float dtSeconds = frame.dtSeconds();
 
-  // Add a gentle fade toward the edges for a more natural look
-  float edgeFade = 0.7f + 0.3f * (1.0f - powf(2.0f * (pos - 0.5f), 2));
+  // Update the animation phase (wraps on its own)
+  // Positive phase increment makes waves appear to move away from index 0
+  phase += Wave::phase(waveSpeed * dtSeconds);
 
-  return value * edgeFade;
+  // Update the color cycle phase
+  colorPhase += Color::hue32(colorCycleSpeed * dtSeconds);
 }
 
-void PulseWaveEffect::update(LEDSegment *segment)
+void PulseWaveEffect::render(LEDSegment *segment, Color *buffer)
 {
   if (!active)
     return;
 
-  unsigned long currentTime = millis();
-  if (lastUpdateTime == 0)
-  {
-    lastUpdateTime = currentTime;
+  if (field.render(segment, buffer, [this](const uint16_t *coords, uint16_t count, Color *colors)
+                   { renderField(coords, count, colors); }))
     return;
-  }
 
-  // Calculate elapsed time in seconds
-  unsigned long dtMillis = currentTime - lastUpdateTime;
-  float dtSeconds = dtMillis / 1000.0f;
-  lastUpdateTime = currentTime;
+  uint16_t numLEDs = segment->getNumLEDs();
+  uint16_t midPoint = numLEDs / 2;
 
-  // Update the animation phase
-  // Positive phase increment makes waves appear to move away from index 0
-  phase += waveSpeed * dtSeconds;
-  if (phase > 1.0f)
+  if (segment->isSymmetric() && midPoint > 0)
   {
-    phase -= 1.0f; // Keep phase in [0, 1) range
+    // Position is the distance from the center (0 at center, 1 at edges),
+    // the segment mirrors the first half
+    renderRun(buffer, segment->getHalfLength(), 1.0f, -1.0f / midPoint);
   }
-
-  // Update the color cycle phase
-  colorPhase += colorCycleSpeed * dtSeconds;
-  while (colorPhase >= 360.0f)
+  else
   {
-    colorPhase -= 360.0f; // Keep in [0, 360) range
+    // Normalized position [0, 1] along the strip
+    renderRun(buffer, numLEDs, 0.0f, numLEDs > 1 ? 1.0f / (numLEDs - 1) : 0.0f);
   }
 }
 
-void PulseWaveEffect::render(LEDSegment *segment, Color *buffer)
+Coverage PulseWaveEffect::getCoverage(LEDSegment *segment)
 {
-  if (!active)
-    return;
+  // Placed segments take the whole field, which is not mirrored by index
+  bool symmetric = segment->isSymmetric() && ledLayout.find(segment) == nullptr;
+  return active ? Coverage{Coverage::FULL, true, symmetric} : Coverage{Coverage::NONE, false};
+}
 
-  uint16_t numLEDs = segment->getNumLEDs();
-  bool isMirrored = false;
+bool PulseWaveEffect::drawsByPosition(const LEDSegment *segment) const
+{
+  return field.renders(segment);
+}
+
+// One LED at normalized position pos (Q24)
+static inline Color pulsePixel(uint32_t wavePhase, uint32_t hue, int32_t pos, uint8_t saturation,
+                               uint32_t brightnessScale)
+{
+  // Gentle fade toward the edges: 0.7 + 0.3 * (1 - (2 * (pos - 0.5))^2) = 0.7 + 1.2 * pos * (1 - pos)
+  uint32_t p = constrain(pos >> 8, 0, 65536); // Q16
+  uint32_t x = (p * (65536 - p)) >> 16;
+  uint32_t edgeFade = 45875 + x + x / 5;
+
+  // Smooth sinusoidal wave from 0 to 1, faded at the edges
+  uint32_t waveVal = ((uint32_t)Wave::unit(wavePhase) * edgeFade) >> 16;
+
+  // Hue varies by position and time, brightness with the wave
+  return Color::hsv2rgb16(hue >> 16, saturation, (waveVal * brightnessScale) >> 16);
+}
 
-  if (segment->getParentStrip()->getType() == LEDStripType::TAILLIGHT ||
-      segment->getParentStrip()->getType() == LEDStripType::UNDERGLOW)
+void PulseWaveEffect::renderRun(Color *buffer, uint16_t count, float posStart, float posStep)
+{
+  // Wave and hue are linear in the position, so both are phase ramps.
+  // Use negative phase to make waves move away from index 0 (or center in mirrored mode).
+  uint32_t wavePhase = Wave::phase(pulseFrequency * posStart) - phase;
+  int32_t waveStep = Wave::phase(pulseFrequency * posStep);
+  uint32_t hue = Color::hue32(baseHue + posStart * hueRange) + colorPhase;
+  int32_t hueStep = Color::hue32(posStep * hueRange);
+
+  // Position in Q24, only needed for the edge fade
+  int32_t pos = posStart * (1 << 24);
+  int32_t posInc = posStep * (1 << 24);
+
+  uint8_t saturation = colorSaturation * 255;
+  uint32_t brightnessScale = intensity * 255;
+
+  for (uint16_t i = 0; i < count; i++)
   {
-    isMirrored = true;
+    buffer[i] = pulsePixel(wavePhase, hue, pos, saturation, brightnessScale);
+
+    wavePhase += waveStep;
+    hue += hueStep;
+    pos += posInc;
   }
+}
 
-  uint16_t midPoint = numLEDs / 2;
+// Positions are no longer evenly spaced, so each one gets its own phases
+void PulseWaveEffect::renderField(const uint16_t *coords, uint16_t count, Color *colors)
+{
+  uint8_t saturation = colorSaturation * 255;
+  uint32_t brightnessScale = intensity * 255;
 
-  for (uint16_t i = 0; i < numLEDs; i++)
+  for (uint16_t i = 0; i < count; i++)
   {
-    float normalizedPos;
-
-    if (isMirrored)
-    {
-      // Calculate position based on distance from center (0 at center, 1 at edges)
-      normalizedPos = static_cast<float>(abs(static_cast<int>(i) - static_cast<int>(midPoint))) / midPoint;
-    }
-    else
-    {
-      // Normalized position [0, 1] along the strip
-      normalizedPos = static_cast<float>(i) / (numLEDs - 1);
-    }
-
-    // Compute wave value at this position
-    float waveVal = computeWave(normalizedPos, phase, pulseFrequency);
-
-    // Calculate the hue based on position and current color phase
-    float posHue = baseHue + colorPhase + (normalizedPos * hueRange);
-    while (posHue >= 360.0f)
-    {
-      posHue -= 360.0f;
-    }
-
-    // Compute color with the calculated parameters
-    Color color = Color::hsv2rgb(
-        posHue,             // Hue varies by position and time
-        colorSaturation,    // Full saturation
-        waveVal * intensity // Brightness varies with the wave
-    );
-
-    // Apply to buffer
-    buffer[i] = color;
+    float pos = coords[i] / (float)LAYOUT_ONE;
+    uint32_t wavePhase = Wave::phase(pulseFrequency * pos) - phase;
+    uint32_t hue = Color::hue32(baseHue + pos * hueRange) + colorPhase;
+    colors[i] = pulsePixel(wavePhase, hue, (int32_t)coords[i] << 10, saturation, brightnessScale);
   }
 }
 
 void PulseWaveEffect::onDisable()
 {
   active = false;
+  setLive(false);
 }
\ No newline at end of file
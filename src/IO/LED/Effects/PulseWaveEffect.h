@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Effects.h"
+#include "../LEDLayout.h"
 #include <stdint.h>
 
 class PulseWaveEffect : public LEDEffect
@@ -9,8 +10,10 @@ public:
   // Constructs the Pulse Wave effect
   PulseWaveEffect(uint8_t priority = 0, bool transparent = false);
 
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
+  virtual bool drawsByPosition(const LEDSegment *segment) const override;
   virtual void onDisable() override;
 
   // Activate or disable the effect
@@ -27,17 +30,18 @@ public:
 private:
   bool active;
 
-  // Time tracking
-  unsigned long lastUpdateTime;
-
   // Animation state
-  float phase;      // Current phase of the wave animation
-  float colorPhase; // Current phase of the color cycle
+  uint32_t phase;      // Current phase of the wave animation (Wave units)
+  uint32_t colorPhase; // Current phase of the color cycle (Color::hue32 units)
 
   // Color parameters
   float baseHue;  // Base hue for the effect (0-360)
   float hueRange; // Range of hue variation (0-360)
 
-  // Creates smooth waves
-  float computeWave(float pos, float phase, float frequency);
+  // Renders count LEDs whose normalized position starts at posStart and moves by posStep
+  void renderRun(Color *buffer, uint16_t count, float posStart, float posStep);
+
+  // Placed segments show waves running from the front to the rear of the car
+  LayoutField field;
+  void renderField(const uint16_t *coords, uint16_t count, Color *colors);
 };
\ No newline at end of file
@@ -7,10 +7,10 @@ RGBEffect::RGBEffect(uint8_t priority, bool transparent)
       baseHueCenter(1.0f), // Default center hue is red.
       baseHueEdge(270.0f), // Default edge hue is violet.
       speed(180.0f),       // Default speed: 60 degrees per second.
-      hueOffset(0.0f),
-      lastUpdateTime(0)
+      hueOffset(0.0f)
 {
   name = "RGB";
+  setLive(false);
   // Initialize the animated hues to the base values.
   hueCenter = baseHueCenter;
   hueEdge = baseHueEdge;
@@ -19,10 +19,7 @@ RGBEffect::RGBEffect(uint8_t priority, bool transparent)
 void RGBEffect::setActive(bool _active)
 {
   active = _active;
-  if (_active && lastUpdateTime == 0)
-  {
-    lastUpdateTime = millis();
-  }
+  setLive(active);
 }
 
 bool RGBEffect::isActive() const
@@ -33,6 +30,7 @@ bool RGBEffect::isActive() const
 void RGBEffect::setSyncData(RGBSyncData syncData)
 {
   active = syncData.active;
+  setLive(active);
   hueCenter = syncData.hueCenter;
   hueEdge = syncData.hueEdge;
   speed = syncData.speed;
@@ -49,24 +47,13 @@ RGBSyncData RGBEffect::getSyncData()
       .active = active};
   return syncData;
 }
-void RGBEffect::update(LEDSegment *segment)
+void RGBEffect::update(const FrameContext &frame)
 {
   // Return if the effect is not active.
   if (!active)
     return;
 
-  unsigned long currentTime = SyncManager::syncMillis();
-  // Initialize last update if needed.
-  if (lastUpdateTime == 0)
-  {
-    lastUpdateTime = currentTime;
-    return;
-  }
-
-  // Calculate elapsed time in seconds.
-  unsigned long dtMillis = currentTime - lastUpdateTime;
-  float dtSeconds = dtMillis / 1000.0f;
-  lastUpdateTime = currentTime;
+  float dtSeconds = frame.dtSeconds();
 
   // Update the cumulative hue offset.
   // speed is in degrees per second.
@@ -99,36 +86,43 @@ void RGBEffect::render(LEDSegment *segment, Color *buffer)
   uint16_t num = segment->getNumLEDs();
   uint16_t mid = num / 2;
 
-  // For every LED, compute the normalized distance from the center.
-  // At the center (distance = 0) use hueCenter; at the edges (distance = 1) use hueEdge.
-  for (uint16_t i = 0; i < num; i++)
+  // Compute the positive angular difference.
+  float diff = hueEdge - hueCenter;
+  if (diff < 0)
   {
-    float normDist = (mid > 0)
-                         ? fabs(static_cast<int>(i) - static_cast<int>(mid)) /
-                               static_cast<float>(mid)
-                         : 0.0f;
-
-    // Compute the positive angular difference.
-    float diff = hueEdge - hueCenter;
-    if (diff < 0)
-    {
-      diff += 360.0f;
-    }
-
-    // Linearly interpolate along the positive direction.
-    float hue = hueCenter - diff * normDist;
-
-    // Normalize the hue to the [0, 360) range.
-    hue = fmod(hue, 360.0f);
-    if (hue < 0)
-      hue += 360.0f;
-
-    Color c = Color::hsv2rgb(hue, 1.0f, 1.0f);
-    buffer[i] = c;
+    diff += 360.0f;
   }
+
+  // The hue only depends on |i - mid|, falling linearly from hueCenter at mid
+  // to hueCenter - diff at distance mid. Convert the ramp from mid to the end
+  // once and mirror it onto the first half. Fixed point hues wrap on their own.
+  int32_t step = (mid > 0) ? (int32_t)Color::hue32(diff / mid) : 0;
+  uint32_t center = Color::hue32(hueCenter);
+
+  // Symmetric segments mirror the first half, which ends at mid
+  if (segment->isSymmetric())
+  {
+    Color::hsv2rgbSpan(buffer, segment->getHalfLength(), center - (uint32_t)step * mid, step, 255, 255);
+    return;
+  }
+
+  Color::hsv2rgbSpan(buffer + mid, num - mid, center, -step, 255, 255);
+
+  for (uint16_t d = 1; d <= mid && mid + d < num; d++)
+    buffer[mid - d] = buffer[mid + d];
+
+  // An even count has one more pixel before mid than after it
+  if (num > 0 && num % 2 == 0)
+    buffer[0] = Color::hsv2rgb16((center - (uint32_t)step * mid) >> 16, 255, 255);
+}
+
+Coverage RGBEffect::getCoverage(LEDSegment *segment)
+{
+  return active ? Coverage{Coverage::FULL, true, segment->isSymmetric()} : Coverage{Coverage::NONE, false};
 }
 
 void RGBEffect::onDisable()
 {
   active = false;
+  setLive(false);
 }
\ No newline at end of file
@@ -9,8 +9,9 @@ public:
   // Constructs the RGB (rainbow) effect. The effect will map the hue from the center to the edges.
   RGBEffect(uint8_t priority = 0, bool transparent = false);
 
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
   virtual void onDisable() override;
 
   // Activate or disable the effect.
@@ -36,7 +37,4 @@ private:
   float hueEdge;
   // Tracks the cumulative hue offset (in degrees).
   float hueOffset;
-
-  // Last update time for animation calculation.
-  unsigned long lastUpdateTime;
 };
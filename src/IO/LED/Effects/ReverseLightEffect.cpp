@@ -12,10 +12,10 @@ static float easeInOut(float t)
 ReverseLightEffect::ReverseLightEffect(uint8_t priority, bool transparent)
     : LEDEffect(priority, transparent),
       active(false),
-      animationSpeed(1.0f), // default 2 seconds for a full animation cycle
-      startTime(0)
+      animationSpeed(1.0f) // default 2 seconds for a full animation cycle
 {
   name = "ReverseLight";
+  setLive(false);
   progress = 0.0f;
 }
 
@@ -25,16 +25,8 @@ void ReverseLightEffect::setActive(bool _active)
     return;
 
   active = _active;
-
   if (active)
-  {
-    startTime = millis();
-    // progress = 0.0f;
-  }
-  else
-  {
-    // progress = 1.0f;
-  }
+    setLive(true);
 }
 
 bool ReverseLightEffect::isActive() const
@@ -47,16 +39,9 @@ bool ReverseLightEffect::isAnimating() const
   return active || progress > 0.0f;
 }
 
-void ReverseLightEffect::update(LEDSegment *segment)
+void ReverseLightEffect::update(const FrameContext &frame)
 {
-  // Get the current time in milliseconds.
-  unsigned long currentTime = millis();
-
-  // Calculate elapsed time in seconds.
-  float deltaTime = (currentTime - startTime) / 1000.0f;
-
-  // Update startTime for the next update call.
-  startTime = currentTime;
+  float deltaTime = frame.dtSeconds();
 
   // Determine how much progress to change.
   float deltaProgress = deltaTime / animationSpeed;
@@ -73,9 +58,10 @@ void ReverseLightEffect::update(LEDSegment *segment)
   else
   {
     progress -= deltaProgress;
-    if (progress < 0.0f)
+    if (progress <= 0.0f)
     {
       progress = 0.0f;
+      setLive(false);
     }
   }
 }
@@ -116,6 +102,13 @@ void ReverseLightEffect::render(LEDSegment *segment, Color *buffer)
   }
 }
 
+Coverage ReverseLightEffect::getCoverage(LEDSegment *segment)
+{
+  if (!active && progress <= 0.0f)
+    return Coverage{Coverage::NONE, false};
+  return Coverage{Coverage::SPANS, true};
+}
+
 void ReverseLightEffect::onDisable()
 {
   active = false;
@@ -10,8 +10,9 @@ public:
   ReverseLightEffect(uint8_t priority = 0,
                      bool transparent = false);
 
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
   virtual void onDisable() override;
 
   // Activate or disable the effect.
@@ -22,7 +23,6 @@ public:
 
 private:
   bool active;
-  uint64_t startTime;
   float animationSpeed; // in seconds for a full cycle (expand then contract)
   float progress;       // from 0 to 1
 };
@@ -1,27 +1,49 @@
 #include "ServiceLightsEffect.h"
 #include <Arduino.h>
-#include <math.h>
 
-// Helper function: Easing function for smoother transitions
-static float easeInOut(float t)
-{
-  return 0.5f * (1.0f - cosf(t * PI));
-}
+// Colour on the left, then on the right
+static constexpr FlashStep SLOW_STEPS[] = {
+    {1, 0, FlashColor::PRIMARY, FlashColor::BLACK},
+    {1, 0, FlashColor::BLACK, FlashColor::PRIMARY},
+};
+
+// A burst of flashes on one side, then on the other
+static constexpr FlashStep FAST_STEPS[] = {
+    {1, FLASHES_CONFIGURED, FlashColor::PRIMARY, FlashColor::BLACK},
+    {1, FLASHES_CONFIGURED, FlashColor::BLACK, FlashColor::PRIMARY},
+};
+
+// Colour on one side and white on the other, swapping
+static constexpr FlashStep ALTERNATE_STEPS[] = {
+    {1, 0, FlashColor::PRIMARY, FlashColor::WHITE},
+    {1, 0, FlashColor::WHITE, FlashColor::PRIMARY},
+};
+
+// 10 Hz strobe on the whole segment, half a second in colour, then in white
+static constexpr FlashStep STROBE_STEPS[] = {
+    {1, 5, FlashColor::PRIMARY, FlashColor::PRIMARY},
+    {1, 5, FlashColor::WHITE, FlashColor::WHITE},
+};
+
+static constexpr FlashPattern SLOW_PATTERN = flashPattern(SLOW_STEPS);
+static constexpr FlashPattern FAST_PATTERN = flashPattern(FAST_STEPS);
+static constexpr FlashPattern ALTERNATE_PATTERN = flashPattern(ALTERNATE_STEPS);
+static constexpr FlashPattern STROBE_PATTERN = flashPattern(STROBE_STEPS);
+
+static const float STROBE_BEAT_SECONDS = 0.05f;
 
 ServiceLightsEffect::ServiceLightsEffect(uint8_t priority, bool transparent)
     : LEDEffect(priority, transparent),
       active(false),
       mode(ServiceLightsMode::FAST),
-      lastUpdateTime(0),
-      flashProgress(0.0f),
-      cycleProgress(0.0f),
+      scrollProgress(0.0f),
       fastSpeed(0.5f),            // 0.5 seconds per full flash cycle in fast mode
       slowSpeed(1.0f),            // 1.0 seconds per full flash cycle in slow mode
       fastModeFlashesPerCycle(3), // 3 flashes per color cycle
-      color(Color::ORANGE),
-      currentFlash(0)
+      color(Color::ORANGE)
 {
   name = "ServiceLights";
+  setLive(false);
 }
 
 void ServiceLightsEffect::setActive(bool a)
@@ -30,13 +52,12 @@ void ServiceLightsEffect::setActive(bool a)
     return;
 
   active = a;
+  setLive(active);
   if (active)
   {
     // Reset animation state when activating
-    lastUpdateTime = millis();
-    flashProgress = 0.0f;
-    cycleProgress = 0.0f;
-    currentFlash = 0;
+    sequencer.reset();
+    scrollProgress = 0.0f;
   }
 }
 
@@ -48,10 +69,10 @@ bool ServiceLightsEffect::isActive() const
 void ServiceLightsEffect::setSyncData(ServiceLightsSyncData syncData)
 {
   active = syncData.active;
+  setLive(active);
   mode = syncData.mode;
-  flashProgress = syncData.progress;
-  cycleProgress = syncData.cycleProgress;
-  currentFlash = syncData.currentFlash;
+  sequencer.setState(syncData.step, syncData.beat);
+  scrollProgress = syncData.scrollProgress;
   fastSpeed = syncData.fastSpeed;
   slowSpeed = syncData.slowSpeed;
   fastModeFlashesPerCycle = syncData.fastModeFlashesPerCycle;
@@ -63,9 +84,9 @@ ServiceLightsSyncData ServiceLightsEffect::getSyncData()
   return ServiceLightsSyncData{
       .active = active,
       .mode = mode,
-      .progress = flashProgress,
-      .cycleProgress = cycleProgress,
-      .currentFlash = currentFlash,
+      .step = sequencer.getStep(),
+      .beat = sequencer.getBeat(),
+      .scrollProgress = scrollProgress,
       .fastSpeed = fastSpeed,
       .slowSpeed = slowSpeed,
       .fastModeFlashesPerCycle = fastModeFlashesPerCycle,
@@ -124,248 +145,106 @@ uint16_t ServiceLightsEffect::getFastModeFlashesPerCycle() const
   return fastModeFlashesPerCycle;
 }
 
-void ServiceLightsEffect::update(LEDSegment *segment)
+const FlashPattern &ServiceLightsEffect::getPattern() const
 {
-  if (!active)
-    return;
-
-  unsigned long currentTime = millis();
-
-  // First update - initialize time
-  if (lastUpdateTime == 0)
-  {
-    lastUpdateTime = currentTime;
-    return;
-  }
-
-  // Calculate the elapsed time in seconds
-  float deltaTime = (currentTime - lastUpdateTime) / 1000.0f;
-  lastUpdateTime = currentTime;
-
-  if (mode == ServiceLightsMode::SLOW)
-  {
-    updateSlowMode(segment, deltaTime);
-  }
-  else if (mode == ServiceLightsMode::FAST)
-  {
-    updateFastMode(segment, deltaTime);
-  }
-  else if (mode == ServiceLightsMode::ALTERNATE)
+  switch (mode)
   {
-    updateAlternateMode(segment, deltaTime);
-  }
-  else if (mode == ServiceLightsMode::STROBE)
-  {
-    updateStrobeMode(segment, deltaTime);
-  }
-  else if (mode == ServiceLightsMode::SCROLL)
-  {
-    updateScrollMode(segment, deltaTime);
+  case ServiceLightsMode::FAST:
+    return FAST_PATTERN;
+  case ServiceLightsMode::ALTERNATE:
+    return ALTERNATE_PATTERN;
+  case ServiceLightsMode::STROBE:
+    return STROBE_PATTERN;
+  default:
+    return SLOW_PATTERN;
   }
 }
 
-void ServiceLightsEffect::render(LEDSegment *segment, Color *buffer)
+float ServiceLightsEffect::getBeatSeconds() const
 {
-  if (!active)
-    return;
-
-  if (mode == ServiceLightsMode::SLOW)
+  // A slow cycle is two steps. A fast flash is one lit and one dark beat.
+  switch (mode)
   {
-    renderSlowMode(segment, buffer);
-  }
-  else if (mode == ServiceLightsMode::FAST)
-  {
-    renderFastMode(segment, buffer);
-  }
-  else if (mode == ServiceLightsMode::ALTERNATE)
-  {
-    renderAlternateMode(segment, buffer);
-  }
-  else if (mode == ServiceLightsMode::STROBE)
-  {
-    renderStrobeMode(segment, buffer);
-  }
-  else if (mode == ServiceLightsMode::SCROLL)
-  {
-    renderScrollMode(segment, buffer);
+  case ServiceLightsMode::FAST:
+    return fastSpeed / fastModeFlashesPerCycle / 2.0f;
+  case ServiceLightsMode::STROBE:
+    return STROBE_BEAT_SECONDS;
+  default:
+    return slowSpeed / 2.0f;
   }
 }
 
-void ServiceLightsEffect::onDisable()
+void ServiceLightsEffect::update(const FrameContext &frame)
 {
-  active = false;
-}
-
-// main logic for each mode
-// ##############################################################
+  if (!active)
+    return;
 
-void ServiceLightsEffect::updateSlowMode(LEDSegment *segment, float deltaTime)
-{
-  // In slow mode, simple toggle between colors
-  cycleProgress += deltaTime / slowSpeed;
-  if (cycleProgress >= 1.0f)
-  {
-    cycleProgress = 0.0f;
-  }
+  if (mode == ServiceLightsMode::SCROLL)
+    updateScrollMode(frame.dtSeconds());
+  else
+    sequencer.update(getPattern(), frame.dtSeconds(), getBeatSeconds(), fastModeFlashesPerCycle);
 }
 
-void ServiceLightsEffect::updateFastMode(LEDSegment *segment, float deltaTime)
+void ServiceLightsEffect::render(LEDSegment *segment, Color *buffer)
 {
-  // Update the flash progress (controls the on/off of each flash)
-  // Each flash consists of an on state and an off state (complete cycle)
-  flashProgress += deltaTime / (fastSpeed / fastModeFlashesPerCycle);
-  if (flashProgress >= 1.0f)
-  {
-    flashProgress = 0.0f;
-
-    // Move to the next flash
-    currentFlash++;
+  if (!active)
+    return;
 
-    // After flashesPerCycle flashes, switch sides
-    if (currentFlash >= fastModeFlashesPerCycle)
-    {
-      currentFlash = 0;
-      cycleProgress = (cycleProgress < 0.5f) ? 0.5f : 0.0f;
-    }
-  }
+  if (mode == ServiceLightsMode::SCROLL)
+    renderScrollMode(segment, buffer);
+  else
+    sequencer.render(getPattern(), buffer, segment->getNumLEDs(), color, color);
 }
 
-void ServiceLightsEffect::updateAlternateMode(LEDSegment *segment, float deltaTime)
+Coverage ServiceLightsEffect::getCoverage(LEDSegment *segment)
 {
-  // In alternate mode, use slowSpeed to control alternating between sides
-  cycleProgress += deltaTime / slowSpeed;
-  if (cycleProgress >= 1.0f)
-  {
-    cycleProgress = 0.0f;
-  }
+  // Both halves are written every frame, off ones black. Only the mirrored
+  // scroll is the same on both sides.
+  bool symmetric = mode == ServiceLightsMode::SCROLL && scrollDrawsHalf(segment);
+  return active ? Coverage{Coverage::FULL, true, symmetric} : Coverage{Coverage::NONE, false};
 }
 
-void ServiceLightsEffect::updateStrobeMode(LEDSegment *segment, float deltaTime)
+// The scroll depends on the strip type, so a taillight and an underglow of
+// the same length must not share a render
+bool ServiceLightsEffect::drawsAlike(const LEDSegment *segment, const LEDSegment *other) const
 {
-  // Update flash progress for strobing effect (faster strobing)
-  flashProgress += deltaTime / 0.1f; // 0.1 second strobe cycle (fast strobe)
-  if (flashProgress >= 1.0f)
-  {
-    flashProgress = 0.0f;
-  }
-
-  // Update cycle progress for color switching (every 1 second)
-  cycleProgress += deltaTime / 1.0f; // 1 second per color switch
-  if (cycleProgress >= 1.0f)
-  {
-    cycleProgress = 0.0f;
-  }
+  return mode != ServiceLightsMode::SCROLL || scrollMirrored(segment) == scrollMirrored(other);
 }
 
-void ServiceLightsEffect::updateScrollMode(LEDSegment *segment, float deltaTime)
+void ServiceLightsEffect::onDisable()
 {
-  // In scroll mode, cycle progress controls the scroll position
-  // Use slowSpeed to control scroll speed
-  cycleProgress += deltaTime / slowSpeed;
-  if (cycleProgress >= 1.0f)
-  {
-    cycleProgress = 0.0f; // Wrap around
-  }
+  active = false;
+  setLive(false);
 }
 
-void ServiceLightsEffect::renderSlowMode(LEDSegment *segment, Color *buffer)
+// The scroll runs out of the middle on the headlights and underglow, the
+// taillights keep one sweep across. Segments of the same length therefore
+// scroll differently by strip type and never share a render, see drawsAlike().
+bool ServiceLightsEffect::scrollMirrored(const LEDSegment *segment) const
 {
-  uint16_t numLEDs = segment->getNumLEDs();
-  uint16_t half = numLEDs / 2;
-
-  // In SLOW mode: alternate between colors on each side with no fade
-  bool isRight = cycleProgress < 0.5f;
-
-  for (uint16_t i = 0; i < numLEDs; i++)
-  {
-    if (i < half) // Left side
-    {
-      buffer[i] = isRight ? color : Color();
-    }
-    else // Right side
-    {
-      buffer[i] = isRight ? Color() : color;
-    }
-  }
+  LEDStripType type = segment->getParentStrip()->getType();
+  return type == LEDStripType::HEADLIGHT || type == LEDStripType::UNDERGLOW;
 }
 
-void ServiceLightsEffect::renderFastMode(LEDSegment *segment, Color *buffer)
+// The mirrored scroll pairs LED i with numLEDs - 1 - i, which a MIRROR
+// segment of even length can copy from the first half
+bool ServiceLightsEffect::scrollDrawsHalf(const LEDSegment *segment) const
 {
-  uint16_t numLEDs = segment->getNumLEDs();
-  uint16_t half = numLEDs / 2;
-
-  // In FAST mode: flash one side for fastModeFlashesPerCycle times, then the other side
-  bool isRightCycle = cycleProgress < 0.5f;
-
-  // Flash intensity based on flash progress
-  // 0-0.5: On, 0.5-1.0: Off
-  float flashIntensity = (flashProgress < 0.5f) ? 1.0f : 0.0f;
-
-  for (uint16_t i = 0; i < numLEDs; i++)
-  {
-    if (isRightCycle)
-    {
-      // Red on left side
-      if (i < half)
-      {
-        buffer[i] = color * flashIntensity;
-      }
-      else
-      {
-        buffer[i] = Color(0, 0, 0); // Right side off during red cycle
-      }
-    }
-    else
-    {
-      // Blue on right side
-      if (i >= half)
-      {
-        buffer[i] = color * flashIntensity;
-      }
-      else
-      {
-        buffer[i] = Color(0, 0, 0); // Left side off during blue cycle
-      }
-    }
-  }
+  return scrollMirrored(segment) && segment->getSymmetry() == SegmentSymmetry::MIRROR &&
+         segment->getNumLEDs() % 2 == 0;
 }
 
-void ServiceLightsEffect::renderAlternateMode(LEDSegment *segment, Color *buffer)
-{
-  uint16_t numLEDs = segment->getNumLEDs();
-  uint16_t half = numLEDs / 2;
-
-  // In ALTERNATE mode: one side color val, other side white, alternating based on slowSpeed
-  bool isColorOnLeft = cycleProgress < 0.5f;
-
-  for (uint16_t i = 0; i < numLEDs; i++)
-  {
-    if (i < half) // Left side
-    {
-      buffer[i] = isColorOnLeft ? color : Color::WHITE;
-    }
-    else // Right side
-    {
-      buffer[i] = isColorOnLeft ? Color::WHITE : color;
-    }
-  }
-}
+// The scroll is a moving position rather than timed steps, so it stays code
+// ##############################################################
 
-void ServiceLightsEffect::renderStrobeMode(LEDSegment *segment, Color *buffer)
+void ServiceLightsEffect::updateScrollMode(float deltaTime)
 {
-  uint16_t numLEDs = segment->getNumLEDs();
-
-  // In STROBE mode: strobe between color val and white, swap every 1 second
-  bool useColorVal = cycleProgress < 0.5f;
-  Color currentColor = useColorVal ? color : Color::WHITE;
-
-  // Strobe intensity based on flash progress
-  // 0-0.5: On, 0.5-1.0: Off
-  float strobeIntensity = (flashProgress < 0.5f) ? 1.0f : 0.0f;
-
-  for (uint16_t i = 0; i < numLEDs; i++)
+  // In scroll mode, scrollProgress controls the scroll position
+  // Use slowSpeed to control scroll speed
+  scrollProgress += deltaTime / slowSpeed;
+  if (scrollProgress >= 1.0f)
   {
-    buffer[i] = currentColor * strobeIntensity;
+    scrollProgress = 0.0f; // Wrap around
   }
 }
 
@@ -374,24 +253,16 @@ void ServiceLightsEffect::renderScrollMode(LEDSegment *segment, Color *buffer)
   uint16_t numLEDs = segment->getNumLEDs();
   uint16_t half = numLEDs / 2;
 
-  bool isMirrored = false;
+  bool isMirrored = scrollMirrored(segment);
 
-  if (segment->getParentStrip()->getType() == LEDStripType::HEADLIGHT ||
-      segment->getParentStrip()->getType() == LEDStripType::UNDERGLOW)
-  {
-    isMirrored = true;
-  }
-
-  if (isMirrored)
-  {
-    half = numLEDs - half;
-  }
+  // A MIRROR segment copies the first half onto the second itself
+  uint16_t count = scrollDrawsHalf(segment) ? segment->getHalfLength() : numLEDs;
 
   // In SCROLL mode: scroll half color val, half white from left to right like lighthouse
-  // cycleProgress (0-1) determines the scroll position
-  int scrollOffset = (int)(cycleProgress * numLEDs);
+  // scrollProgress (0-1) determines the scroll position
+  int scrollOffset = (int)(scrollProgress * numLEDs);
 
-  for (uint16_t i = 0; i < numLEDs; i++)
+  for (uint16_t i = 0; i < count; i++)
   {
     int patternPos;
     uint16_t patternSize;
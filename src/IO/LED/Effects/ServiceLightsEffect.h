@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Effects.h"
+#include "../FlashPattern.h"
 #include <stdint.h>
 
 class ServiceLightsEffect : public LEDEffect
@@ -9,8 +10,10 @@ public:
   // Constructs the police light effect
   ServiceLightsEffect(uint8_t priority = 0, bool transparent = false);
 
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
+  virtual bool drawsAlike(const LEDSegment *segment, const LEDSegment *other) const override;
   virtual void onDisable() override;
 
   // Activate or disable the effect
@@ -34,16 +37,7 @@ public:
   void setFastModeFlashesPerCycle(uint16_t flashes);
   uint16_t getFastModeFlashesPerCycle() const;
 
-  void updateSlowMode(LEDSegment *segment, float deltaTime);
-  void updateFastMode(LEDSegment *segment, float deltaTime);
-  void updateAlternateMode(LEDSegment *segment, float deltaTime);
-  void updateStrobeMode(LEDSegment *segment, float deltaTime);
-  void updateScrollMode(LEDSegment *segment, float deltaTime);
-
-  void renderSlowMode(LEDSegment *segment, Color *buffer);
-  void renderFastMode(LEDSegment *segment, Color *buffer);
-  void renderAlternateMode(LEDSegment *segment, Color *buffer);
-  void renderStrobeMode(LEDSegment *segment, Color *buffer);
+  void updateScrollMode(float deltaTime);
   void renderScrollMode(LEDSegment *segment, Color *buffer);
 
 private:
@@ -51,10 +45,8 @@ private:
   ServiceLightsMode mode;
 
   // Animation parameters
-  unsigned long lastUpdateTime;
-  float flashProgress;   // Tracks the current position in the flash cycle (0-1)
-  float cycleProgress;   // Tracks which color is currently displayed
-  uint16_t currentFlash; // Tracks the current flash count in FAST mode
+  FlashSequencer sequencer; // every mode but SCROLL
+  float scrollProgress;     // position in the SCROLL cycle (0-1)
 
   // Configuration parameters
   float fastSpeed;                  // Flash cycle speed in seconds (fast mode)
@@ -63,4 +55,9 @@ private:
 
   // Colors
   Color color;
+
+  const FlashPattern &getPattern() const;
+  float getBeatSeconds() const;
+  bool scrollMirrored(const LEDSegment *segment) const;
+  bool scrollDrawsHalf(const LEDSegment *segment) const;
 };
\ No newline at end of file
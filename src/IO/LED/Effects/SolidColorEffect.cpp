@@ -8,11 +8,13 @@ SolidColorEffect::SolidColorEffect(uint8_t priority, bool transparent)
       customColor(255, 255, 255)
 {
   name = "SolidColor";
+  setLive(false);
 }
 
 void SolidColorEffect::setActive(bool _active)
 {
   active = _active;
+  setLive(active);
 }
 
 bool SolidColorEffect::isActive() const
@@ -50,6 +52,7 @@ bool SolidColorEffect::isUsingCustomColor() const
 void SolidColorEffect::setSyncData(SolidColorSyncData syncData)
 {
   active = syncData.active;
+  setLive(active);
   colorPreset = syncData.colorPreset;
   customColor = Color(syncData.customR, syncData.customG, syncData.customB);
 }
@@ -120,7 +123,7 @@ Color SolidColorEffect::presetToColor(SolidColorPreset preset) const
   }
 }
 
-void SolidColorEffect::update(LEDSegment *segment)
+void SolidColorEffect::update(const FrameContext &frame)
 {
   // Solid color effect doesn't need complex updates - it's static
   // Just return if not active
@@ -143,7 +146,13 @@ void SolidColorEffect::render(LEDSegment *segment, Color *buffer)
   }
 }
 
+Coverage SolidColorEffect::getCoverage(LEDSegment *segment)
+{
+  return active ? Coverage{Coverage::FULL, true} : Coverage{Coverage::NONE, false};
+}
+
 void SolidColorEffect::onDisable()
 {
   active = false;
+  setLive(false);
 }
\ No newline at end of file
@@ -1,41 +1,105 @@
 #include "TaillightEffect.h"
-#include <cmath>
 #include <Arduino.h>
 
+// Keyframes measure from the middle of the segment to either end. The first
+// two tracks of every timeline are the middle and the end.
+enum TaillightTrack : uint8_t
+{
+  MIDDLE,
+  END,
+  DASH_OUTER,
+  DASH_INNER,
+  FILL,
+  SPLIT,
+};
+
+static constexpr Keyframe MIDDLE_KEYS[] = {keyframe(0, 0.0f)};
+static constexpr Keyframe END_KEYS[] = {keyframe(0, 1.0f)};
+
+// Startup: two dashes run out to the ends and back, a fill sweeps out from
+// the middle, holds, then the middle opens up leaving 15 LEDs at each end
+static constexpr Keyframe DASH_OUTER_KEYS[] = {
+    keyframe(0, 0.0f),
+    keyframe(600, 1.0f, 0, 0, Ease::SMOOTH),
+    keyframe(1200, 0.0f, 0, 0, Ease::SMOOTH),
+};
+static constexpr Keyframe DASH_INNER_KEYS[] = {
+    keyframe(0, 0.0f, 0, -15),
+    keyframe(600, 1.0f, 0, -2, Ease::SMOOTH), // the dash shrinks into the end
+    keyframe(1200, 0.0f, 0, -15, Ease::SMOOTH),
+};
+
+// The fill starts from the dashes: they grow back to 15 LEDs over the first
+// fifth of the eased sweep, which then takes them along out to the ends.
+// Sampled into linear pieces, one keyframe can only ease the whole sweep.
+static constexpr uint16_t FILL_START_MS = 1200;
+static constexpr uint16_t FILL_MS = 600;
+static constexpr uint8_t FILL_STEPS = 12;
+static constexpr float FILL_DASH_LEDS = 15.0f;
+
+struct FillKeys
+{
+  Keyframe keys[FILL_STEPS + 1];
+};
+
+static constexpr FillKeys fillKeys()
+{
+  FillKeys fill{};
+  for (uint8_t k = 0; k <= FILL_STEPS; k++)
+  {
+    float t = (float)k / FILL_STEPS;
+    float p = t * t * (3.0f - 2.0f * t);
+    float dash = p < 0.2f ? p * 5.0f * FILL_DASH_LEDS : FILL_DASH_LEDS;
+    fill.keys[k] = keyframe(FILL_START_MS + k * FILL_MS / FILL_STEPS, p, 0, (int8_t)(dash * (1.0f - p) / 2.0f + 0.5f));
+  }
+  return fill;
+}
+
+static constexpr FillKeys FILL_KEYS = fillKeys();
+
+static constexpr Keyframe SPLIT_KEYS[] = {
+    keyframe(2100, 0.0f),
+    keyframe(2700, 1.0f, 0, -15, Ease::SMOOTH),
+};
+
+static constexpr Track STARTUP_TRACKS[] = {
+    track(MIDDLE_KEYS), track(END_KEYS), track(DASH_OUTER_KEYS),
+    track(DASH_INNER_KEYS), track(FILL_KEYS.keys), track(SPLIT_KEYS),
+};
+static constexpr TimelineSpan STARTUP_SPANS[] = {
+    {0, 1200, DASH_INNER, DASH_OUTER, 255},
+    {1200, 1800, MIDDLE, FILL, 255},
+    {1800, TIMELINE_FOREVER, SPLIT, END, 255},
+    {2100, TIMELINE_FOREVER, MIDDLE, SPLIT, 0},
+};
+static constexpr Timeline STARTUP = timeline(STARTUP_TRACKS, STARTUP_SPANS, 2700, TimelineAnchor::CENTER);
+
+// Steady states
+static constexpr Track STEADY_TRACKS[] = {track(MIDDLE_KEYS), track(END_KEYS)};
+static constexpr TimelineSpan CAR_ON_SPANS[] = {{0, TIMELINE_FOREVER, MIDDLE, END, 0}};
+static constexpr TimelineSpan DIM_SPANS[] = {{0, TIMELINE_FOREVER, MIDDLE, END, 20}};
+static constexpr Timeline CAR_ON = timeline(STEADY_TRACKS, CAR_ON_SPANS, 0, TimelineAnchor::CENTER);
+static constexpr Timeline DIM = timeline(STEADY_TRACKS, DIM_SPANS, 0, TimelineAnchor::CENTER);
+
 TaillightEffect::TaillightEffect(uint8_t priority, bool transparent)
     : LEDEffect(priority, transparent),
       mode(TaillightEffectMode::Off),
       previousMode(TaillightEffectMode::Off),
-      phase(-1),
-      phase_start(0),
-      lastUpdate(0),
-      split(false),
-      // Startup timing (from TaillightStartupEffect)
-      T_startup_dot(0.0f),
-      T_startup_dash_out(0.6f),
-      T_startup_dash_in(0.6f),
-      T_startup_fill(0.6f),
-      T_startup_delay(0.3f),
-      T_startup_split(0.6f),
-      // Transition timing
-      T_mode_transition(0.5f),
-      // Effect parameters
-      startup_dash_length(15),
-      startup_edge_stop(15),
-      // Progress variables
-      phase_progress(0.0f),
-      startup_outward_progress(0.0f),
-      startup_inward_progress(0.0f),
-      startup_fill_progress(0.0f),
-      startup_split_progress(0.0f),
-      transition_progress(0.0f)
+      split(false)
 {
   name = "Taillight";
+  setLive(false);
+}
+
+void TaillightEffect::play(const Timeline *timeline, uint16_t position)
+{
+  player.play(timeline, position);
+  setLive(timeline != nullptr);
 }
 
 bool TaillightEffect::isActive()
 {
-  return mode != TaillightEffectMode::Off || phase != -1;
+  return mode != TaillightEffectMode::Off || player.getTimeline() != nullptr;
 }
 
 void TaillightEffect::setOff()
@@ -45,8 +109,7 @@ void TaillightEffect::setOff()
 
   previousMode = mode;
   mode = TaillightEffectMode::Off;
-  phase = -1;
-  phase_start = 0;
+  play(nullptr);
 }
 
 void TaillightEffect::setStartup()
@@ -56,14 +119,7 @@ void TaillightEffect::setStartup()
 
   previousMode = mode;
   mode = TaillightEffectMode::Startup;
-  phase = 0;
-  phase_start = millis();
-
-  // Reset startup progress
-  startup_outward_progress = 0.0f;
-  startup_inward_progress = 0.0f;
-  startup_fill_progress = 0.0f;
-  startup_split_progress = 0.0f;
+  play(&STARTUP);
 }
 
 void TaillightEffect::setCarOn()
@@ -73,8 +129,7 @@ void TaillightEffect::setCarOn()
 
   previousMode = mode;
   mode = TaillightEffectMode::CarOn;
-  phase = 10; // CarOn steady state
-  phase_start = millis();
+  play(&CAR_ON);
 }
 
 void TaillightEffect::setDim()
@@ -84,8 +139,7 @@ void TaillightEffect::setDim()
 
   previousMode = mode;
   mode = TaillightEffectMode::Dim;
-  phase = 20; // Dim steady state
-  phase_start = millis();
+  play(&DIM);
 }
 
 void TaillightEffect::setMode(TaillightEffectMode newMode)
@@ -138,241 +192,50 @@ bool TaillightEffect::getSplit()
 
 bool TaillightEffect::isAnimating()
 {
-  return phase != -1 && mode == TaillightEffectMode::Startup;
+  return mode == TaillightEffectMode::Startup && !player.isFinished();
 }
 
-void TaillightEffect::update(LEDSegment *segment)
+uint16_t TaillightEffect::getTimelinePosition()
 {
-  if (mode == TaillightEffectMode::Off && phase == -1)
-    return;
-
-  unsigned long now = millis();
-  if (phase_start == 0)
-    phase_start = now;
-
-  unsigned long dtMillis = now - lastUpdate;
-  float dtSeconds = dtMillis / 1000.0f;
-  lastUpdate = now;
-
-  float elapsed = (now - phase_start) / 1000.0f;
-
-  // Handle mode-specific updates
-  switch (mode)
-  {
-  case TaillightEffectMode::Startup:
-    _updateStartupEffect(segment, elapsed);
-    break;
-
-  case TaillightEffectMode::CarOn:
-  case TaillightEffectMode::Dim:
-  case TaillightEffectMode::Off:
-    // Steady states - no updates needed
-    break;
-  }
+  return player.getPosition();
 }
 
-void TaillightEffect::_updateStartupEffect(LEDSegment *segment, float elapsed)
+void TaillightEffect::setTimelinePosition(uint16_t position)
 {
-  if (phase == 0) // Red dot phase
-  {
-    if (elapsed >= T_startup_dot)
-    {
-      phase = 1;
-      phase_start = millis();
-    }
-  }
-  else if (phase == 1) // Dash outward
-  {
-    startup_outward_progress = std::min(elapsed / T_startup_dash_out, 1.0f);
-    startup_outward_progress = _easeInOut(startup_outward_progress);
-
-    if (startup_outward_progress >= 1.0f)
-    {
-      phase = 2;
-      phase_start = millis();
-    }
-  }
-  else if (phase == 2) // Dash inward
-  {
-    startup_inward_progress = std::min(elapsed / T_startup_dash_in, 1.0f);
-    startup_inward_progress = _easeInOut(startup_inward_progress);
-
-    if (startup_inward_progress >= 1.0f)
-    {
-      phase = 3;
-      phase_start = millis();
-    }
-  }
-  else if (phase == 3) // Fill sweep
-  {
-    startup_fill_progress = std::min(elapsed / T_startup_fill, 1.0f);
-
-    if (startup_fill_progress >= 1.0f)
-    {
-      phase = 4;
-      phase_start = millis();
-    }
-  }
-  else if (phase == 4) // Delay with full red
-  {
-    if (elapsed >= T_startup_delay)
-    {
-      phase = 5;
-      phase_start = millis();
-    }
-  }
-  else if (phase == 5) // Split & fade
-  {
-    startup_split_progress = std::min(elapsed / T_startup_split, 1.0f);
+  player.setPosition(position);
+}
 
-    if (startup_split_progress >= 1.0f)
-    {
-      phase = 6; // Final steady state
-      phase_start = millis();
-    }
-  }
+void TaillightEffect::update(const FrameContext &frame)
+{
+  player.update(frame.ms());
 }
 
 void TaillightEffect::render(LEDSegment *segment, Color *buffer)
 {
-  if (mode == TaillightEffectMode::Off && phase == -1)
+  const Timeline *timeline = player.getTimeline();
+  if (timeline == nullptr)
     return;
 
   uint16_t numLEDs = segment->getNumLEDs();
+  const uint16_t measures[] = {(uint16_t)((numLEDs + 1) / 2)};
 
-  // Handle normal mode rendering
-  switch (mode)
-  {
-  case TaillightEffectMode::Startup:
-    _renderStartupEffect(segment, buffer);
-    break;
-
-  case TaillightEffectMode::CarOn:
-    // CarOn mode is all off by default (as requested)
-    for (int i = 0; i < numLEDs; i++)
-    {
-      buffer[i] = Color(0, 0, 0);
-    }
-    break;
-
-  case TaillightEffectMode::Dim:
-    _renderDimEffect(segment, buffer);
-    break;
+  TimelineRun runs[TIMELINE_MAX_SPANS];
+  uint8_t count = player.resolve(measures, numLEDs, runs);
 
-  case TaillightEffectMode::Off:
-  default:
-    // All off
-    for (int i = 0; i < numLEDs; i++)
-    {
-      buffer[i] = Color(0, 0, 0);
-    }
-    break;
-  }
-}
-
-void TaillightEffect::_renderStartupEffect(LEDSegment *segment, Color *buffer)
-{
-  uint16_t numLEDs = segment->getNumLEDs();
-  float center = numLEDs / 2.0f;
   Color color = _getTaillightColor();
-
-  if (phase == 0) // Red dot at center
-  {
-    int idx = (int)round(center);
-    if (idx >= 0 && idx < numLEDs)
-      buffer[idx] = color;
-  }
-  else if (phase == 1 || phase == 2) // Dash phases
-  {
-    float progress = (phase == 1) ? startup_outward_progress : (1.0f - startup_inward_progress);
-
-    float left_dash_pos = center - (progress * center);
-    float right_dash_pos = center + (progress * center);
-
-    int left_start = (int)round(left_dash_pos);
-    int right_start = (int)round(right_dash_pos);
-
-    int left_size = (int)std::min((float)startup_dash_length, center - left_start);
-    int right_size = (int)std::min((float)startup_dash_length, right_start - center);
-
-    // Adjust sizes if near the edges
-    if (left_start < startup_dash_length)
-    {
-      left_size -= startup_dash_length - left_start;
-      if (left_size < 2)
-        left_size = 2;
-    }
-    if (right_start + startup_dash_length > numLEDs)
-    {
-      right_size -= (right_start + startup_dash_length) - numLEDs;
-      if (right_size < 2)
-        right_size = 2;
-    }
-
-    for (uint16_t i = 0; i < numLEDs; i++)
-    {
-      if (i >= left_start && i < left_start + left_size)
-        buffer[i] = color;
-      else if (i >= right_start - right_size && i < right_start)
-        buffer[i] = color;
-    }
-  }
-  else if (phase == 3) // Fill sweep
-  {
-    float p = startup_fill_progress;
-    p = _easeInOut(p);
-
-    float new_dash_length = (p <= 0.2f) ? (p * 5.0f * startup_dash_length) : startup_dash_length;
-    p = (1 - ((float)new_dash_length / numLEDs)) * p + ((float)new_dash_length / numLEDs);
-
-    for (int i = 0; i < numLEDs; i++)
-    {
-      if (i <= center)
-      {
-        if ((center - i) <= p * center)
-          buffer[i] = color;
-      }
-      else
-      {
-        if ((i - center) <= p * (numLEDs - 1 - center))
-          buffer[i] = color;
-      }
-    }
-  }
-  else if (phase == 4) // Full red
-  {
-    for (int i = 0; i < numLEDs; i++)
-    {
-      buffer[i] = color;
-    }
-  }
-  else if (phase >= 5) // Split & fade
-  {
-    float p = startup_split_progress;
-    p = _easeInOut(p);
-
-    float left_cutoff = center - p * (center - startup_edge_stop);
-    float right_cutoff = center + p * ((numLEDs - startup_edge_stop) - center);
-
-    for (int i = 0; i < numLEDs; i++)
-    {
-      if (i < left_cutoff || i >= right_cutoff)
-        buffer[i] = color;
-      else
-        buffer[i] = Color(0, 0, 0);
-    }
-  }
+  for (uint8_t i = 0; i < count; i++)
+    TimelinePlayer::fill(buffer, numLEDs, timeline->anchor, runs[i], color);
 }
 
-void TaillightEffect::_renderDimEffect(LEDSegment *segment, Color *buffer)
+Coverage TaillightEffect::getCoverage(LEDSegment *segment)
 {
-  uint16_t numLEDs = segment->getNumLEDs();
+  if (player.getTimeline() == nullptr)
+    return Coverage{Coverage::NONE, false};
 
-  // Dim red for all LEDs
-  for (uint16_t i = 0; i < numLEDs; i++)
-  {
-    buffer[i] = Color(20, 0, 0); // Dim red
-  }
+  // The steady modes light the whole segment
+  if (player.isPlaying(&DIM) || player.isPlaying(&CAR_ON))
+    return Coverage{Coverage::FULL, true};
+  return Coverage{Coverage::SPANS, true};
 }
 
 Color TaillightEffect::_getTaillightColor()
@@ -380,13 +243,8 @@ Color TaillightEffect::_getTaillightColor()
   return Color(255, 0, 0); // Red for taillights
 }
 
-float TaillightEffect::_easeInOut(float t)
-{
-  return 3 * t * t - 2 * t * t * t;
-}
-
 void TaillightEffect::onDisable()
 {
-  phase = -1;
   mode = TaillightEffectMode::Off;
-}
\ No newline at end of file
+  play(nullptr);
+}
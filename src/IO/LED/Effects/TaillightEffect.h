@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Effects.h"
+#include "../Timeline.h"
 #include <stdint.h>
 
 enum class TaillightEffectMode
@@ -16,8 +17,9 @@ class TaillightEffect : public LEDEffect
 public:
   TaillightEffect(uint8_t priority = 0, bool transparent = false);
 
-  virtual void update(LEDSegment *segment) override;
+  virtual void update(const FrameContext &frame) override;
   virtual void render(LEDSegment *segment, Color *buffer) override;
+  virtual Coverage getCoverage(LEDSegment *segment) override;
   virtual void onDisable() override;
 
   bool isActive();
@@ -37,53 +39,18 @@ public:
   // State query methods
   bool isAnimating();
 
+  // Position in the current mode's animation (ms), for syncing
+  uint16_t getTimelinePosition();
+  void setTimelinePosition(uint16_t position);
+
 private:
-  // Core state variables
   TaillightEffectMode mode;
   TaillightEffectMode previousMode;
-  int phase;                 // Current animation phase
-  unsigned long phase_start; // Timestamp when current phase started
-  unsigned long lastUpdate;  // Last update timestamp
 
   bool split;
 
-  // Timing parameters (in seconds)
-  // Startup effect timing
-  float T_startup_dot;      // Red dot duration
-  float T_startup_dash_out; // Dash outward duration
-  float T_startup_dash_in;  // Dash inward duration
-  float T_startup_fill;     // Fill sweep duration
-  float T_startup_delay;    // Full red hold duration
-  float T_startup_split;    // Split & fade duration
-
-  // Transition timing
-  float T_mode_transition; // General mode transition duration
-
-  // Effect parameters
-  uint16_t startup_dash_length; // Startup dash length
-  uint16_t startup_edge_stop;   // Final red region size at strip ends
-
-  // Progress tracking variables
-  float phase_progress; // General phase progress (0 to 1)
-
-  // Startup specific progress
-  float startup_outward_progress;
-  float startup_inward_progress;
-  float startup_fill_progress;
-  float startup_split_progress;
+  TimelinePlayer player; // plays the animation of the current mode
+  void play(const Timeline *timeline, uint16_t position = 0); // nullptr stops, the effect sleeps
 
-  // Mode transition progress
-  float transition_progress;
-
-  // Helper methods
   Color _getTaillightColor();
-  void _updateStartupEffect(LEDSegment *segment, float elapsed);
-  void _updateModeTransition(LEDSegment *segment, float elapsed);
-
-  void _renderStartupEffect(LEDSegment *segment, Color *buffer);
-  void _renderDimEffect(LEDSegment *segment, Color *buffer);
-  void _renderModeTransition(LEDSegment *segment, Color *buffer);
-
-  // Easing functions
-  float _easeInOut(float t);
-};
\ No newline at end of file
+};
@@ -0,0 +1,86 @@
+#include "FlashPattern.h"
+#include <algorithm>
+
+FlashSequencer::FlashSequencer()
+{
+  reset();
+}
+
+void FlashSequencer::reset()
+{
+  step = 0;
+  beat = 0.0f;
+}
+
+void FlashSequencer::setState(uint8_t _step, float _beat)
+{
+  step = _step;
+  beat = _beat;
+}
+
+void FlashSequencer::update(const FlashPattern &pattern, float dtSeconds, float beatSeconds, uint8_t flashes)
+{
+  if (pattern.count == 0 || beatSeconds <= 0.0f)
+    return;
+
+  // The pattern may have changed under a step index from another mode
+  if (step >= pattern.count)
+    reset();
+
+  beat += dtSeconds / beatSeconds;
+
+  // Carry the remainder so the pattern keeps time over any frame rate
+  for (uint8_t guard = 0; guard < pattern.count; guard++)
+  {
+    const FlashStep &current = pattern.steps[step];
+    uint8_t count = current.flashes == FLASHES_CONFIGURED ? flashes : current.flashes;
+    float length = count == 0 ? current.beats : 2.0f * current.beats * count;
+
+    if (beat < length)
+      return;
+
+    beat -= length;
+    step = (step + 1) % pattern.count;
+  }
+
+  // More than a whole pattern in one frame, start over
+  beat = 0.0f;
+}
+
+static inline Color resolve(FlashColor color, const Color &primary, const Color &secondary)
+{
+  switch (color)
+  {
+  case FlashColor::PRIMARY:
+    return primary;
+  case FlashColor::SECONDARY:
+    return secondary;
+  case FlashColor::WHITE:
+    return Color::WHITE;
+  default:
+    return Color(0, 0, 0);
+  }
+}
+
+void FlashSequencer::render(const FlashPattern &pattern, Color *buffer, uint16_t numLEDs,
+                            const Color &primary, const Color &secondary) const
+{
+  if (pattern.count == 0)
+    return;
+
+  const FlashStep &current = pattern.steps[step < pattern.count ? step : 0];
+  FlashColor left = current.left;
+  FlashColor right = current.right;
+
+  // Flashing steps are dark every other stretch of beats
+  bool lit = current.flashes == 0 || ((uint32_t)(beat / current.beats) & 1) == 0;
+  if (!lit)
+  {
+    left = FlashColor::BLACK;
+    right = FlashColor::BLACK;
+  }
+
+  uint16_t half = numLEDs / 2;
+  std::fill(buffer, buffer + half, resolve(left, primary, secondary));
+  std::fill(buffer + half, buffer + numLEDs, resolve(right, primary, secondary));
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Color.h"
+
+// Flash modes (police, service lights) as data: a pattern is a table of
+// steps, each lighting the two halves of a segment in a colour for a number
+// of beats. The effect decides how long a beat is, so one table serves every
+// speed setting, and a FlashSequencer plays it back. A new strobe pattern is
+// a new table.
+
+// Colour of one half of the segment, resolved by the effect. Every step
+// writes both halves opaquely, a half that is off is black.
+enum class FlashColor : uint8_t
+{
+  BLACK,
+  PRIMARY,
+  SECONDARY,
+  WHITE,
+};
+
+// FlashStep::flashes value that takes the count from the effect's settings
+static constexpr uint8_t FLASHES_CONFIGURED = 0xFF;
+
+struct FlashStep
+{
+  uint8_t beats;    // how long the step is lit, and then dark if it flashes
+  uint8_t flashes;  // 0: lit for beats. n: n times lit then dark (both halves BLACK)
+  FlashColor left;  // first half of the segment
+  FlashColor right; // second half
+};
+
+struct FlashPattern
+{
+  const FlashStep *steps;
+  uint8_t count;
+};
+
+template <size_t N>
+constexpr FlashPattern flashPattern(const FlashStep (&steps)[N])
+{
+  return FlashPattern{steps, (uint8_t)N};
+}
+
+// Plays a FlashPattern. Its whole state is the step index and the time into
+// the step, which is all a sync message needs to carry.
+class FlashSequencer
+{
+public:
+  FlashSequencer();
+
+  void reset();
+
+  // Advance by dtSeconds. flashes replaces FLASHES_CONFIGURED in the table.
+  void update(const FlashPattern &pattern, float dtSeconds, float beatSeconds, uint8_t flashes);
+
+  // Fill both halves of buffer with the current step
+  void render(const FlashPattern &pattern, Color *buffer, uint16_t numLEDs,
+              const Color &primary, const Color &secondary) const;
+
+  uint8_t getStep() const { return step; }
+  float getBeat() const { return beat; }
+  void setState(uint8_t step, float beat);
+
+private:
+  uint8_t step;
+  float beat; // time into the step in beats
+};
@@ -0,0 +1,60 @@
+#include "FrameDeadline.h"
+
+FrameDeadline::FrameDeadline()
+{
+  periodUs = 1000000 / 60;
+  reset();
+}
+
+void FrameDeadline::setPeriodUs(uint32_t _periodUs)
+{
+  periodUs = _periodUs > 0 ? _periodUs : 1;
+}
+
+uint32_t FrameDeadline::getPeriodUs() const { return periodUs; }
+
+bool FrameDeadline::frameDone(uint32_t frameStart, uint32_t now)
+{
+  frames++;
+
+  // Achieved rate from frame start to frame start over at least a second
+  if (windowFrames == 0)
+    windowStart = frameStart;
+  windowFrames++;
+  uint32_t windowTime = frameStart - windowStart;
+  if (windowTime >= 1000000)
+  {
+    achievedFps = ((uint64_t)(windowFrames - 1) * 1000000 + windowTime / 2) / windowTime;
+    windowStart = frameStart;
+    windowFrames = 1;
+  }
+
+  uint32_t frameTime = now - frameStart;
+  if (frameTime <= periodUs)
+    return false;
+
+  missedDeadlines++;
+  if (frameTime - periodUs > worstOverrunUs)
+    worstOverrunUs = frameTime - periodUs;
+  return true;
+}
+
+void FrameDeadline::reset()
+{
+  frames = 0;
+  missedDeadlines = 0;
+  worstOverrunUs = 0;
+  windowStart = 0;
+  windowFrames = 0;
+  achievedFps = 0;
+}
+
+uint16_t FrameDeadline::getTargetFps() const { return (1000000 + periodUs / 2) / periodUs; }
+
+uint16_t FrameDeadline::getAchievedFps() const { return achievedFps; }
+
+uint32_t FrameDeadline::getFrames() const { return frames; }
+
+uint32_t FrameDeadline::getMissedDeadlines() const { return missedDeadlines; }
+
+uint32_t FrameDeadline::getWorstOverrunUs() const { return worstOverrunUs; }
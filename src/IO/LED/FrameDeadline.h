@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+
+// Checks frames against a fixed period and keeps the numbers we need to
+// know whether the draw loop keeps up: missed deadlines, the worst overrun
+// and the achieved frame rate.
+//
+// Written by LEDStripTask only. Readers on other tasks may see values one
+// frame old.
+class FrameDeadline
+{
+public:
+  FrameDeadline();
+
+  void setPeriodUs(uint32_t periodUs);
+  uint32_t getPeriodUs() const;
+
+  // Record a frame that started at frameStart and was finished at now
+  // (both micros()). Returns true if it missed its deadline.
+  bool frameDone(uint32_t frameStart, uint32_t now);
+
+  // Clear the counters, keeping the period
+  void reset();
+
+  uint16_t getTargetFps() const;
+  uint16_t getAchievedFps() const; // over the last full second
+  uint32_t getFrames() const;
+  uint32_t getMissedDeadlines() const;
+  uint32_t getWorstOverrunUs() const; // by how much the worst frame missed
+
+private:
+  uint32_t periodUs;
+
+  uint32_t frames;
+  uint32_t missedDeadlines;
+  uint32_t worstOverrunUs;
+
+  uint32_t windowStart;
+  uint32_t windowFrames;
+  uint16_t achievedFps;
+};
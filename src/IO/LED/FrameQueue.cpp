@@ -0,0 +1,77 @@
+#include "FrameQueue.h"
+#include <string.h>
+#include "FastLED.h"
+#include "LEDArena.h"
+
+FrameQueue::FrameQueue(uint16_t numLEDs, const String &owner)
+{
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    slots[i] = ledArena.allocate<CRGB>(numLEDs, LED_FRAME_PLACEMENT, owner + " frame " + String(i));
+    sequence[i] = 0;
+    hash[i] = 0;
+  }
+
+  back = 0;
+  middle.store(1);
+  front = 2;
+  lastPublished = 2;
+
+  publishedFrames = 0;
+  shownSequence = 0;
+  droppedFrames = 0;
+  repeatedFrames = 0;
+}
+
+FrameQueue::~FrameQueue()
+{
+  for (uint8_t i = 0; i < 3; i++)
+    ledArena.release(slots[i]);
+}
+
+CRGB *FrameQueue::getBack() { return slots[back]; }
+
+const CRGB *FrameQueue::getLastPublished() { return slots[lastPublished]; }
+
+void FrameQueue::publish(uint32_t frameHash)
+{
+  sequence[back] = ++publishedFrames;
+  hash[back] = frameHash;
+  lastPublished = back;
+
+  // Release orders the frame's pixels before the slot becomes visible
+  uint8_t previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+  back = previous & INDEX_MASK;
+}
+
+bool FrameQueue::acquire()
+{
+  if (!(middle.load(std::memory_order_relaxed) & FRESH))
+  {
+    repeatedFrames++;
+    return false;
+  }
+
+  uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+  front = previous & INDEX_MASK;
+
+  // Any sequence numbers skipped were overwritten in the middle slot
+  uint32_t frontSequence = sequence[front];
+  if (shownSequence != 0 && frontSequence > shownSequence + 1)
+    droppedFrames += frontSequence - shownSequence - 1;
+  shownSequence = frontSequence;
+
+  return true;
+}
+
+CRGB *FrameQueue::getFront() { return slots[front]; }
+
+uint32_t FrameQueue::getFrontSequence() const { return shownSequence; }
+
+uint32_t FrameQueue::getFrontHash() const { return hash[front]; }
+
+uint32_t FrameQueue::getPublishedFrames() const { return publishedFrames; }
+
+uint32_t FrameQueue::getDroppedFrames() const { return droppedFrames; }
+
+uint32_t FrameQueue::getRepeatedFrames() const { return repeatedFrames; }
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <Arduino.h>
+
+struct CRGB;
+
+// Lock-free triple buffer handing finished frames from the app loop
+// (producer) to LEDStripTask (consumer).
+//
+// Slots hold finished frames in strip order and FastLED's pixel layout, so
+// the consumer can hand the front slot to the controller as is. The producer
+// fills getBack() and publish()es it, which swaps it with the middle slot. The consumer's acquire() swaps the middle slot into
+// front if a newer frame is waiting. Neither side blocks, and the consumer
+// never sees a frame that is still being rendered.
+class FrameQueue
+{
+public:
+  FrameQueue(uint16_t numLEDs, const String &owner); // owner: name in the LEDArena report
+  ~FrameQueue();
+
+  // === PRODUCER ===
+  CRGB *getBack();
+  const CRGB *getLastPublished(); // only valid on the producer side
+  void publish(uint32_t hash);    // hash: fingerprint of the frame's pixels
+
+  // === CONSUMER ===
+  // Returns true if a new frame was taken, false if front is a repeat
+  bool acquire();
+  CRGB *getFront();
+  uint32_t getFrontSequence() const;
+  uint32_t getFrontHash() const;
+
+  // === STATS ===
+  uint32_t getPublishedFrames() const;
+  uint32_t getDroppedFrames() const;  // published but replaced before they were shown
+  uint32_t getRepeatedFrames() const; // draws that found no new frame
+
+private:
+  static const uint8_t INDEX_MASK = 0x03;
+  static const uint8_t FRESH = 0x04; // middle slot holds an unconsumed frame
+
+  CRGB *slots[3];
+  uint32_t sequence[3];
+  uint32_t hash[3];
+
+  uint8_t back;  // owned by the producer
+  uint8_t front; // owned by the consumer
+  uint8_t lastPublished;
+  std::atomic<uint8_t> middle;
+
+  uint32_t publishedFrames;
+  uint32_t shownSequence;
+  uint32_t droppedFrames;
+  uint32_t repeatedFrames;
+};
@@ -0,0 +1,187 @@
+#include "LEDArena.h"
+#include "Color.h"
+#include "FastLED.h"
+#include <esp_heap_caps.h>
+
+LEDArena ledArena;
+
+static const uint32_t INTERNAL_CAPS = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+static const uint32_t PSRAM_CAPS = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+
+static inline size_t align4(size_t bytes) { return (bytes + 3) & ~(size_t)3; }
+
+static const char *placementName(ArenaPlacement placement)
+{
+  return placement == ArenaPlacement::INTERNAL ? "internal" : "PSRAM";
+}
+
+LEDArena::LEDArena()
+{
+  for (Block &b : blocks)
+  {
+    b.base = nullptr;
+    b.capacity = 0;
+    b.used = 0;
+  }
+  psramIsInternal = false;
+}
+
+bool LEDArena::reserve(size_t internalBytes, size_t psramBytes)
+{
+  if (block(ArenaPlacement::INTERNAL).base || block(ArenaPlacement::PSRAM).base)
+  {
+    Serial.println("LEDArena: already reserved");
+    return false;
+  }
+
+  internalBytes = align4(internalBytes);
+  psramBytes = align4(psramBytes);
+
+  Block &internal = block(ArenaPlacement::INTERNAL);
+  internal.base = (uint8_t *)heap_caps_malloc(internalBytes, INTERNAL_CAPS);
+  if (!internal.base)
+  {
+    Serial.println("LEDArena: failed to reserve " + String(internalBytes) + " bytes of internal RAM");
+    return false;
+  }
+  internal.capacity = internalBytes;
+
+  if (psramBytes == 0)
+    return true;
+
+  Block &psram = block(ArenaPlacement::PSRAM);
+  psram.base = (uint8_t *)heap_caps_malloc(psramBytes, PSRAM_CAPS);
+  if (!psram.base)
+  {
+    // No PSRAM on this board, the secondary buffers go to internal RAM
+    psram.base = (uint8_t *)heap_caps_malloc(psramBytes, INTERNAL_CAPS);
+    psramIsInternal = true;
+  }
+  if (!psram.base)
+  {
+    Serial.println("LEDArena: failed to reserve " + String(psramBytes) + " bytes for PSRAM placement");
+    return false;
+  }
+  psram.capacity = psramBytes;
+
+  return true;
+}
+
+void *LEDArena::allocate(size_t bytes, ArenaPlacement placement, const String &owner)
+{
+  bytes = align4(bytes);
+
+  Entry entry;
+  entry.bytes = bytes;
+  entry.placement = placement;
+  entry.released = false;
+  entry.owner = owner;
+
+  Block &b = block(placement);
+  if (b.base && b.capacity - b.used >= bytes)
+  {
+    entry.ptr = b.base + b.used;
+    entry.fromHeap = false;
+    b.used += bytes;
+  }
+  else
+  {
+    if (b.base)
+      Serial.println("LEDArena: " + String(placementName(placement)) + " block full, " + owner +
+                     " (" + String(bytes) + " bytes) goes to the heap");
+
+    entry.ptr = heap_caps_malloc(bytes, placement == ArenaPlacement::PSRAM ? PSRAM_CAPS : INTERNAL_CAPS);
+    if (!entry.ptr && placement == ArenaPlacement::PSRAM)
+      entry.ptr = heap_caps_malloc(bytes, INTERNAL_CAPS);
+    if (!entry.ptr)
+    {
+      Serial.println("LEDArena: out of memory for " + owner + " (" + String(bytes) + " bytes)");
+      return nullptr;
+    }
+    entry.fromHeap = true;
+  }
+
+  memset(entry.ptr, 0, bytes);
+  entries.push_back(entry);
+  return entry.ptr;
+}
+
+void LEDArena::release(void *ptr)
+{
+  if (!ptr)
+    return;
+
+  for (size_t i = 0; i < entries.size(); i++)
+  {
+    if (entries[i].ptr != ptr)
+      continue;
+
+    if (entries[i].fromHeap)
+    {
+      heap_caps_free(ptr);
+      entries.erase(entries.begin() + i);
+    }
+    else
+      entries[i].released = true;
+    return;
+  }
+
+  Serial.println("LEDArena: release of a buffer it does not own");
+}
+
+size_t LEDArena::stripBytes(uint16_t numLEDs, ArenaPlacement placement)
+{
+  size_t bytes = 0;
+
+  // Render buffer, and room to compose one full-length overlapping segment
+  if (placement == ArenaPlacement::INTERNAL)
+    bytes += 2 * align4(numLEDs * sizeof(Color));
+
+  // Three published frames
+  if (placement == LED_FRAME_PLACEMENT)
+    bytes += 3 * align4(numLEDs * sizeof(CRGB));
+
+  return bytes;
+}
+
+size_t LEDArena::getCapacity(ArenaPlacement placement) const { return block(placement).capacity; }
+
+size_t LEDArena::getUsed(ArenaPlacement placement) const { return block(placement).used; }
+
+size_t LEDArena::getHeapBytes() const
+{
+  size_t bytes = 0;
+  for (const Entry &entry : entries)
+    if (entry.fromHeap)
+      bytes += entry.bytes;
+  return bytes;
+}
+
+void LEDArena::printReport()
+{
+  Serial.println("=== LED MEMORY ===");
+  Serial.printf("%-32s %8s  %s\n", "Buffer", "Bytes", "Placement");
+
+  size_t released = 0;
+  for (const Entry &entry : entries)
+  {
+    const char *where = entry.fromHeap ? "heap" : placementName(entry.placement);
+    if (!entry.fromHeap && entry.placement == ArenaPlacement::PSRAM && psramIsInternal)
+      where = "internal (no PSRAM)";
+
+    Serial.printf("%-32s %8u  %s%s\n", entry.owner.c_str(), (unsigned int)entry.bytes, where,
+                  entry.released ? ", released" : "");
+    if (entry.released)
+      released += entry.bytes;
+  }
+
+  Serial.println();
+  Serial.printf("Internal: %u / %u bytes used\n",
+                (unsigned int)getUsed(ArenaPlacement::INTERNAL), (unsigned int)getCapacity(ArenaPlacement::INTERNAL));
+  Serial.printf("PSRAM:    %u / %u bytes used%s\n",
+                (unsigned int)getUsed(ArenaPlacement::PSRAM), (unsigned int)getCapacity(ArenaPlacement::PSRAM),
+                psramIsInternal ? " (in internal RAM)" : "");
+  Serial.printf("Heap:     %u bytes outside the arena\n", (unsigned int)getHeapBytes());
+  if (released > 0)
+    Serial.printf("Released: %u bytes held until restart\n", (unsigned int)released);
+}
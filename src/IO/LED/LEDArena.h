@@ -0,0 +1,92 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+enum class ArenaPlacement
+{
+  INTERNAL, // internal RAM, for buffers touched every frame
+  PSRAM,    // external RAM if the board has it, internal otherwise
+};
+
+// Published frames are written once and read once per frame. Build with
+// -DLED_ARENA_PSRAM_FRAMES to place them in PSRAM. Off by default: the RMT
+// driver reads them from its interrupt, which PSRAM makes slower.
+#ifdef LED_ARENA_PSRAM_FRAMES
+#define LED_FRAME_PLACEMENT ArenaPlacement::PSRAM
+#else
+#define LED_FRAME_PLACEMENT ArenaPlacement::INTERNAL
+#endif
+
+// Room kept for buffers owned by effects
+#define LED_ARENA_EFFECT_BYTES 2048
+
+// Holds every LED buffer in two blocks reserved once at startup, one in
+// internal RAM and one in PSRAM, so strips, segments and effects never
+// fragment the heap and an LED configuration that does not fit is known at
+// boot instead of after a long drive.
+//
+// Allocation is a bump of a pointer and memory is only given back on
+// restart. Before reserve() is called, or once a block is full, buffers come
+// from the heap instead, so host builds and tests need no setup. Only used
+// while the strips are set up, from one task.
+class LEDArena
+{
+public:
+  LEDArena();
+
+  // Reserve both blocks. Returns false if they could not be allocated.
+  bool reserve(size_t internalBytes, size_t psramBytes);
+
+  // Zeroed memory for count elements of a trivially copyable type. owner
+  // names the strip, segment or effect in the report.
+  template <typename T>
+  T *allocate(size_t count, ArenaPlacement placement, const String &owner)
+  {
+    return static_cast<T *>(allocate(count * sizeof(T), placement, owner));
+  }
+  void *allocate(size_t bytes, ArenaPlacement placement, const String &owner);
+
+  // Heap buffers are freed, arena buffers stay used until restart
+  void release(void *ptr);
+
+  // Bytes a strip of numLEDs needs in each placement, headroom for composing
+  // its segments included
+  static size_t stripBytes(uint16_t numLEDs, ArenaPlacement placement);
+
+  size_t getCapacity(ArenaPlacement placement) const;
+  size_t getUsed(ArenaPlacement placement) const;
+  size_t getHeapBytes() const; // live buffers that did not fit or came before reserve()
+
+  // Bytes per strip, segment and effect buffer, with totals
+  void printReport();
+
+private:
+  struct Block
+  {
+    uint8_t *base;
+    size_t capacity;
+    size_t used;
+  };
+
+  struct Entry
+  {
+    void *ptr;
+    size_t bytes;
+    ArenaPlacement placement;
+    bool fromHeap;
+    bool released;
+    String owner;
+  };
+
+  Block blocks[2]; // indexed by ArenaPlacement
+  bool psramIsInternal; // no PSRAM, the PSRAM block lives in internal RAM
+  std::vector<Entry> entries;
+
+  Block &block(ArenaPlacement placement) { return blocks[static_cast<int>(placement)]; }
+  const Block &block(ArenaPlacement placement) const { return blocks[static_cast<int>(placement)]; }
+};
+
+extern LEDArena ledArena;
@@ -0,0 +1,135 @@
+#include "LEDLayout.h"
+#include "LEDStrip.h"
+#include <algorithm>
+#include <math.h>
+
+LEDLayout ledLayout;
+
+LEDLayout::LEDLayout()
+{
+  version = 0;
+}
+
+void LEDLayout::place(LEDSegment *segment, uint16_t start, uint16_t count, LEDPoint first, LEDPoint last)
+{
+  runs.push_back(Run{segment, start, count, first, last});
+}
+
+void LEDLayout::place(LEDSegment *segment, LEDPoint first, LEDPoint last)
+{
+  place(segment, 0, segment->getNumLEDs(), first, last);
+}
+
+void LEDLayout::remove(LEDSegment *segment)
+{
+  runs.erase(std::remove_if(runs.begin(), runs.end(), [segment](const Run &run)
+                            { return run.segment == segment; }),
+             runs.end());
+  segments.erase(std::remove_if(segments.begin(), segments.end(), [segment](const SegmentLayout &placed)
+                                { return placed.segment == segment; }),
+                 segments.end());
+}
+
+const SegmentLayout *LEDLayout::find(const LEDSegment *segment) const
+{
+  for (const SegmentLayout &placed : segments)
+  {
+    if (placed.segment == segment)
+      return &placed;
+  }
+  return nullptr;
+}
+
+// a / b rounded half away from zero, b > 0. Mirrored offsets round to
+// mirrored positions, so the two halves of a centred run dedupe exactly.
+static int32_t divRound(int64_t a, int32_t b)
+{
+  return a >= 0 ? (a + b / 2) / b : -((-a + b / 2) / b);
+}
+
+static uint16_t axisCoord(LayoutAxis axis, int32_t x, int32_t y)
+{
+  switch (axis)
+  {
+  case LayoutAxis::ACROSS:
+    return constrain((x + LAYOUT_ONE) / 2, 0, LAYOUT_ONE);
+  case LayoutAxis::AROUND:
+    return lroundf(atan2f(fabsf(x), y) / (float)M_PI * LAYOUT_ONE);
+  }
+  return 0;
+}
+
+void LEDLayout::build()
+{
+  segments.clear();
+  for (const Run &run : runs)
+  {
+    if (find(run.segment) == nullptr)
+    {
+      segments.push_back(SegmentLayout{run.segment, {}});
+      for (auto &index : segments.back().index)
+        index.assign(run.segment->getNumLEDs(), 0);
+    }
+  }
+
+  // Coordinates of every LED first, the index tables hold them until the
+  // distinct ones are known
+  for (auto &axisCoords : coords)
+    axisCoords.clear();
+
+  for (const Run &run : runs)
+  {
+    SegmentLayout &placed = *std::find_if(segments.begin(), segments.end(), [&run](const SegmentLayout &s)
+                                          { return s.segment == run.segment; });
+    uint16_t numLEDs = placed.index[0].size();
+    if (run.start >= numLEDs)
+      continue;
+    uint16_t count = std::min<uint16_t>(run.count, numLEDs - run.start);
+
+    // Offsets from the middle of the run, so a run centred on the car is
+    // placed symmetrically
+    int32_t midX = (run.first.x + run.last.x) / 2;
+    int32_t midY = (run.first.y + run.last.y) / 2;
+    int32_t spanX = run.last.x - run.first.x;
+    int32_t spanY = run.last.y - run.first.y;
+    int32_t steps = count > 1 ? 2 * (count - 1) : 1;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+      int32_t t = count > 1 ? 2 * i - (count - 1) : 0; // -(count - 1) to count - 1
+      int32_t x = midX + divRound((int64_t)spanX * t, steps);
+      int32_t y = midY + divRound((int64_t)spanY * t, steps);
+
+      for (uint8_t a = 0; a < LAYOUT_AXES; a++)
+      {
+        uint16_t coord = axisCoord((LayoutAxis)a, x, y);
+        placed.index[a][run.start + i] = coord;
+        coords[a].push_back(coord);
+      }
+    }
+  }
+
+  for (uint8_t a = 0; a < LAYOUT_AXES; a++)
+  {
+    std::vector<uint16_t> &axisCoords = coords[a];
+    std::sort(axisCoords.begin(), axisCoords.end());
+    axisCoords.erase(std::unique(axisCoords.begin(), axisCoords.end()), axisCoords.end());
+    if (axisCoords.empty())
+      axisCoords.push_back(0);
+
+    for (SegmentLayout &placed : segments)
+    {
+      for (uint16_t &entry : placed.index[a])
+        entry = std::lower_bound(axisCoords.begin(), axisCoords.end(), entry) - axisCoords.begin();
+    }
+  }
+
+  version++;
+
+  size_t placedLEDs = 0;
+  for (const SegmentLayout &placed : segments)
+    placedLEDs += placed.index[0].size();
+  Serial.printf("LEDLayout: %u LEDs on %u segments, %u across and %u around\n", (unsigned)placedLEDs,
+                (unsigned)segments.size(), (unsigned)coords[(int)LayoutAxis::ACROSS].size(),
+                (unsigned)coords[(int)LayoutAxis::AROUND].size());
+}
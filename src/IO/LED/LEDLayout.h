@@ -0,0 +1,135 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "Color.h"
+#include "Effects.h"
+
+class LEDSegment;
+
+// Optional physical layout of the strips around the car. Each placed LED
+// gets a position, and spatial effects evaluate one field in car space
+// instead of running along each segment's indices, so headlights,
+// taillights and underglow show one continuous picture. The tables are
+// built once at startup. A field is evaluated once per frame per distinct
+// coordinate, LEDs that share one (the mirrored halves of a centred strip)
+// share the work, then every placed segment looks its pixels up.
+
+// Car space in Q14, x from -16384 (left) to 16384 (right) and y from
+// -16384 (rear) to 16384 (front)
+struct LEDPoint
+{
+  int16_t x;
+  int16_t y;
+};
+
+static constexpr int16_t LAYOUT_ONE = 16384;
+
+constexpr LEDPoint layoutPoint(float x, float y)
+{
+  return LEDPoint{(int16_t)(x * LAYOUT_ONE + (x < 0 ? -0.5f : 0.5f)), (int16_t)(y * LAYOUT_ONE + (y < 0 ? -0.5f : 0.5f))};
+}
+
+// What a field varies along, as a coordinate from 0 to LAYOUT_ONE
+enum class LayoutAxis : uint8_t
+{
+  ACROSS, // left to right
+  AROUND, // angle from the front centre to the rear centre, both sides alike
+};
+
+static constexpr uint8_t LAYOUT_AXES = 2;
+
+// Lookup tables for one placed segment, in the order effects index it
+struct SegmentLayout
+{
+  LEDSegment *segment;
+  std::vector<uint16_t> index[LAYOUT_AXES]; // per LED, into LEDLayout::getCoords()
+};
+
+class LEDLayout
+{
+public:
+  LEDLayout();
+
+  // Put LEDs [start, start + count) of segment evenly on the line from
+  // first to last. A segment may be placed in several runs, LEDs left out
+  // sit at the first coordinate. Takes effect on build().
+  void place(LEDSegment *segment, uint16_t start, uint16_t count, LEDPoint first, LEDPoint last);
+  void place(LEDSegment *segment, LEDPoint first, LEDPoint last);
+
+  // Forget segment, called when it is deleted
+  void remove(LEDSegment *segment);
+
+  // Compute every placed LED's coordinates and the lookup tables, once
+  // everything is placed
+  void build();
+
+  // Placement of segment, nullptr if it is not placed
+  const SegmentLayout *find(const LEDSegment *segment) const;
+
+  // Distinct coordinates along axis, ascending
+  const std::vector<uint16_t> &getCoords(LayoutAxis axis) const { return coords[(int)axis]; }
+
+  // Changes with every build(), fields evaluated before are stale
+  uint32_t getVersion() const { return version; }
+
+private:
+  struct Run
+  {
+    LEDSegment *segment;
+    uint16_t start;
+    uint16_t count;
+    LEDPoint first;
+    LEDPoint last;
+  };
+
+  std::vector<Run> runs;
+  std::vector<SegmentLayout> segments;
+  std::vector<uint16_t> coords[LAYOUT_AXES];
+  uint32_t version;
+};
+
+extern LEDLayout ledLayout;
+
+// One effect's colours at every coordinate of an axis, evaluated at most
+// once per frame however many segments show them
+class LayoutField
+{
+public:
+  explicit LayoutField(LayoutAxis axis) : axis(axis), version(0), frame(0) {}
+
+  // Fill buffer for a placed segment and return true, evaluating the field
+  // first if it is stale with evaluate(coords, count, colors). Returns false
+  // for segments that are not placed, the effect draws those by index.
+  // True if render() fills segment from the field
+  bool renders(const LEDSegment *segment) const { return ledLayout.find(segment) != nullptr; }
+
+  template <typename Evaluate>
+  bool render(const LEDSegment *segment, Color *buffer, Evaluate evaluate)
+  {
+    const SegmentLayout *placed = ledLayout.find(segment);
+    if (placed == nullptr)
+      return false;
+
+    uint32_t now = LEDEffect::getFrame().frame;
+    if (version != ledLayout.getVersion() || frame != now)
+    {
+      const std::vector<uint16_t> &coords = ledLayout.getCoords(axis);
+      colors.resize(coords.size()); // allocates after a build() only
+      evaluate(coords.data(), (uint16_t)coords.size(), colors.data());
+      version = ledLayout.getVersion();
+      frame = now;
+    }
+
+    const std::vector<uint16_t> &index = placed->index[(int)axis];
+    for (size_t i = 0; i < index.size(); i++)
+      buffer[i] = colors[index[i]];
+    return true;
+  }
+
+private:
+  LayoutAxis axis;
+  uint32_t version; // of the layout the colours were evaluated for
+  uint32_t frame;
+  std::vector<Color> colors;
+};
@@ -1,145 +1,8 @@
 #include "LEDStrip.h"
+#include "LEDArena.h"
+#include "LEDLayout.h"
 #include <algorithm>
 
-// Implementation of the Color structure.
-// Range of h: [0, 360), s: [0, 1], v: [0, 1]
-// Returns: RGB color with components in the range [0, 255].
-Color Color::hsv2rgb(float h, float s, float v)
-{
-  float r, g, b;
-  int i;
-  float f, p, q, t;
-
-  if (s == 0)
-  {
-    r = g = b = v;
-    return Color(r * 255, g * 255, b * 255);
-  }
-
-  h /= 60; // sector 0 to 5
-  i = floor(h);
-  f = h - i;
-  p = v * (1 - s);
-  q = v * (1 - s * f);
-  t = v * (1 - s * (1 - f));
-
-  switch (i)
-  {
-  case 0:
-    r = v;
-    g = t;
-    b = p;
-    break;
-  case 1:
-    r = q;
-    g = v;
-    b = p;
-    break;
-  case 2:
-    r = p;
-    g = v;
-    b = t;
-    break;
-  case 3:
-    r = p;
-    g = q;
-    b = v;
-    break;
-  case 4:
-    r = t;
-    g = p;
-    b = v;
-    break;
-  default: // case 5:
-    r = v;
-    g = p;
-    b = q;
-    break;
-  }
-
-  return Color(r * 255, g * 255, b * 255);
-}
-
-Color Color::rgb2hsv(uint8_t r, uint8_t g, uint8_t b)
-{
-  float h, s, v;
-  float max = std::max(r, std::max(g, b));
-  float min = std::min(r, std::min(g, b));
-
-  v = max;
-  s = max != 0 ? (max - min) / max : 0;
-
-  if (s == 0)
-  {
-    h = 0;
-  }
-  else
-  {
-    h = 60 * (g - b) / (max - min);
-  }
-
-  return Color(h, s, v);
-}
-
-uint32_t Color::to32Bit() const // wwrrggbb
-{
-  // return (w << 24) | (r << 16) | (g << 8) | b;
-  uint32_t v;
-  memcpy(&v, this, sizeof(v));
-  return v;
-}
-
-void Color::print() const
-{
-  char buffer[100];
-  int idx = 0;
-
-  idx += snprintf(buffer, sizeof(buffer), "R:%03d G:%03d B:%03d", r, g, b);
-
-  if (w != 0)
-    idx += snprintf(buffer + idx, sizeof(buffer) - idx, " W:%03d", w);
-
-  if (w == 0)
-    snprintf(buffer + idx, sizeof(buffer) - idx, " [#%02X%02X%02X]", r, g, b);
-  else
-    snprintf(buffer + idx, sizeof(buffer) - idx, " [#%02X%02X%02X%02X]", r, g, b, w);
-
-  Serial.println(buffer);
-}
-
-void Color::print(const Color &color)
-{
-  color.print();
-}
-
-void Color::print(const Color *colors, uint16_t numLEDs)
-{
-  for (uint16_t i = 0; i < numLEDs; i++)
-  {
-    Serial.printf("LED %03d: ", i);
-    colors[i].print();
-  }
-}
-
-void Color::print(const CRGB *colors, uint16_t numLEDs)
-{
-  for (uint16_t i = 0; i < numLEDs; i++)
-  {
-    Serial.printf("LED %03d: ", i);
-    Color::print(Color(colors[i].r, colors[i].g, colors[i].b));
-  }
-}
-
-const Color Color::WHITE = Color(255, 255, 255);
-const Color Color::BLACK = Color(0, 0, 0);
-const Color Color::RED = Color(255, 0, 0);
-const Color Color::ORANGE = Color(255, 40, 0);
-const Color Color::GREEN = Color(0, 255, 0);
-const Color Color::BLUE = Color(0, 0, 255);
-const Color Color::YELLOW = Color(255, 255, 0);
-const Color Color::CYAN = Color(0, 255, 255);
-const Color Color::MAGENTA = Color(255, 0, 255);
-
 LEDSegment::LEDSegment(LEDStrip *_parentStrip, String _name, uint16_t _startIndex, uint16_t _numLEDs)
 {
   name = _name;
@@ -148,6 +11,15 @@ LEDSegment::LEDSegment(LEDStrip *_parentStrip, String _name, uint16_t _startInde
   parentStrip = _parentStrip;
   isEnabled = true;
   fliped = false;
+  ledBuffer = nullptr;
+  composeBuffer = nullptr;
+  composited = false;
+  coversAll = false;
+  mirrorBottom = false;
+  symmetry = SegmentSymmetry::NONE;
+  liveChanged = false;
+  segmentMutex = nullptr;
+  profilerId = PROFILER_INVALID_ID;
 
   if (startIndex >= parentStrip->numLEDs)
   {
@@ -183,9 +55,7 @@ LEDSegment::LEDSegment(LEDStrip *_parentStrip, String _name, uint16_t _startInde
 
   segmentMutex = xSemaphoreCreateMutex();
 
-  // ledBuffer = parentStrip->getBuffer() + startIndex; // this still might me better
-  ledBuffer = new Color[numLEDs];
-  memset(ledBuffer, 0, numLEDs * sizeof(Color));
+  ledBuffer = parentStrip->ledBuffer + startIndex;
 
   parentStrip->segments.push_back(this);
   isEnabled = parentStrip->isEnabled;
@@ -201,6 +71,15 @@ LEDSegment::LEDSegment(LEDStrip *_parentStrip, String _name)
   parentStrip = _parentStrip;
   isEnabled = true;
   fliped = false;
+  ledBuffer = nullptr;
+  composeBuffer = nullptr;
+  composited = false;
+  coversAll = false;
+  mirrorBottom = false;
+  symmetry = SegmentSymmetry::NONE;
+  liveChanged = false;
+  segmentMutex = nullptr;
+  profilerId = PROFILER_INVALID_ID;
 
   if (parentStrip->numLEDs == 0)
   {
@@ -216,8 +95,7 @@ LEDSegment::LEDSegment(LEDStrip *_parentStrip, String _name)
 
   segmentMutex = xSemaphoreCreateMutex();
 
-  ledBuffer = new Color[numLEDs];
-  memset(ledBuffer, 0, numLEDs * sizeof(Color));
+  ledBuffer = parentStrip->ledBuffer;
 
   parentStrip->segments.push_back(this);
   isEnabled = parentStrip->isEnabled;
@@ -227,8 +105,12 @@ LEDSegment::LEDSegment(LEDStrip *_parentStrip, String _name)
 
 LEDSegment::~LEDSegment()
 {
+  for (auto effect : effects)
+    effect->segments.erase(std::remove(effect->segments.begin(), effect->segments.end(), this), effect->segments.end());
+
   parentStrip->segments.erase(std::remove(parentStrip->segments.begin(), parentStrip->segments.end(), this), parentStrip->segments.end());
-  delete[] ledBuffer;
+  ledLayout.remove(this);
+  ledArena.release(composeBuffer);
 
   if (segmentMutex != nullptr)
   {
@@ -241,12 +123,12 @@ Color *LEDSegment::getBuffer()
   return ledBuffer;
 }
 
-uint16_t LEDSegment::getNumLEDs()
+uint16_t LEDSegment::getNumLEDs() const
 {
   return numLEDs;
 }
 
-LEDStrip *LEDSegment::getParentStrip()
+LEDStrip *LEDSegment::getParentStrip() const
 {
   return parentStrip;
 }
@@ -266,16 +148,30 @@ bool LEDSegment::getEnabled()
 void LEDSegment::addEffect(LEDEffect *effect)
 {
   effects.push_back(effect);
+  effect->segments.push_back(this);
+
+  // Room for the bottom layer the effect's segments of this length share
+  for (const LEDSegment *other : effect->segments)
+    if (other != this && other->numLEDs == numLEDs && effect->shared.colors.size() < numLEDs)
+      effect->shared.colors.resize(numLEDs);
   std::sort(effects.begin(), effects.end(),
             [](const LEDEffect *a, const LEDEffect *b)
             {
               return a->getPriority() < b->getPriority();
             });
+  liveEffects.reserve(effects.size());
+  layers.reserve(effects.size());
+  liveChanged = true;
+  parentStrip->updateSegmentLayout();
 }
 
 void LEDSegment::removeEffect(LEDEffect *effect)
 {
   effects.erase(std::remove(effects.begin(), effects.end(), effect), effects.end());
+  effect->segments.erase(std::remove(effect->segments.begin(), effect->segments.end(), this), effect->segments.end());
+  liveEffects.erase(std::remove(liveEffects.begin(), liveEffects.end(), effect), liveEffects.end());
+  layers.clear();
+  parentStrip->updateSegmentLayout();
 }
 
 uint16_t LEDSegment::effectCount()
@@ -283,88 +179,241 @@ uint16_t LEDSegment::effectCount()
   return effects.size();
 }
 
-void LEDSegment::updateEffects()
+void LEDSegment::setSymmetry(SegmentSymmetry _symmetry)
 {
-  if (xSemaphoreTake(segmentMutex, portMAX_DELAY) == pdTRUE)
+  symmetry = _symmetry;
+}
+
+SegmentSymmetry LEDSegment::getSymmetry() const
+{
+  return symmetry;
+}
+
+bool LEDSegment::isSymmetric() const
+{
+  return symmetry != SegmentSymmetry::NONE;
+}
+
+uint16_t LEDSegment::getHalfLength() const
+{
+  switch (symmetry)
   {
-    String profilerKey = name + "_UpdateEffectsSeg";
-    timeProfiler.start(profilerKey);
+  case SegmentSymmetry::MIRROR:
+    return (numLEDs + 1) / 2;
+  case SegmentSymmetry::MIRROR_CENTER:
+    return numLEDs > 0 ? numLEDs / 2 + 1 : 0;
+  default:
+    return numLEDs;
+  }
+}
 
-    clearBufferUnsafe();
+void LEDSegment::mirrorHalf()
+{
+  if (symmetry == SegmentSymmetry::MIRROR)
+  {
+    std::reverse_copy(ledBuffer, ledBuffer + numLEDs / 2, ledBuffer + numLEDs - numLEDs / 2);
+  }
+  else if (symmetry == SegmentSymmetry::MIRROR_CENTER && numLEDs > 0)
+  {
+    uint16_t center = numLEDs / 2;
+    uint16_t right = numLEDs - 1 - center;
+    std::reverse_copy(ledBuffer + center - right, ledBuffer + center, ledBuffer + center + 1);
+  }
+}
 
-#ifdef USE_2_BUFFERS
-    Color tempBuffer[numLEDs] = {Color::BLACK};
-#endif
+// Rebuilt only when an effect wakes up or goes idle, which is rare next to
+// frames. Filtering effects keeps their order for equal priorities.
+void LEDSegment::collectLiveEffects()
+{
+  liveChanged = false;
+  liveEffects.clear();
+  for (auto effect : effects)
+  {
+    if (effect->isLive())
+      liveEffects.push_back(effect);
+  }
+}
 
-    for (auto effect : effects)
+// Walk the live effects top down. Ones that draw nothing are left out, and
+// the first one that hides everything below it is the bottom layer. update()
+// still runs for every live effect, so hidden ones keep time.
+void LEDSegment::planLayers()
+{
+  if (liveChanged)
+    collectLiveEffects();
+
+  layers.clear();
+  coversAll = false;
+  mirrorBottom = false;
+
+  for (size_t i = liveEffects.size(); i-- > 0;)
+  {
+    Coverage coverage = liveEffects[i]->getCoverage(this);
+    if (coverage.area == Coverage::NONE)
+      continue;
+
+    layers.push_back(liveEffects[i]);
+    if (coverage.hidesBelow())
     {
+      coversAll = true;
+      mirrorBottom = coverage.symmetric && isSymmetric();
+      break;
+    }
+  }
 
-      // Serial.printf("    Updating effect: %s. segment: %s. strip: %s.\n", effect->name.c_str(), name.c_str(), parentStrip->name.c_str());
+  std::reverse(layers.begin(), layers.end());
+}
 
-      effect->update(this);
+void LEDSegment::renderEffects()
+{
+  // Nothing to render, and a flipped view must not reverse pixels it does not own
+  if (effects.empty())
+    return;
 
-#ifdef USE_2_BUFFERS
-      // Render the current effect into tempBuffer.
-      effect->render(this, tempBuffer);
-#else
+  if (xSemaphoreTake(segmentMutex, portMAX_DELAY) == pdTRUE)
+  {
+    // Registered on first use, the name can still change while strips are set up
+    if (profilerId == PROFILER_INVALID_ID)
+      profilerId = timeProfiler.registerKey(name + "_RenderEffectsSeg");
+    timeProfiler.start(profilerId);
 
-      effect->render(this, ledBuffer);
-#endif
+    // In-place segments share the strip buffer, which the strip already cleared
+    if (composited && !coversAll)
+      clearBufferUnsafe();
 
-#ifdef USE_2_BUFFERS
-      // Merge the rendered result from tempBuffer into ledBuffer.
-      if (effect->isTransparent())
-      {
-        // For transparent effects, only copy pixels that are not black.
-        uint32_t black32 = Color::BLACK.to32Bit();
-        for (uint16_t i = 0; i < numLEDs; i++)
-        {
-          if (tempBuffer[i].to32Bit() != black32)
-            ledBuffer[i] = tempBuffer[i];
-        }
-      }
+    // Lowest priority first, each one blends over the ones before it
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+      // Serial.printf("    Rendering effect: %s. segment: %s. strip: %s.\n", layers[i]->name.c_str(), name.c_str(), parentStrip->name.c_str());
+      if (i == 0)
+        renderBottom(layers[i]);
       else
-      {
-        // For opaque effects, overwrite the entire ledBuffer.
-        ledBuffer = tempBuffer;
-      }
-#endif
+        layers[i]->render(this, ledBuffer);
     }
 
+    if (composited)
+      compose();
+    else if (fliped)
+      std::reverse(ledBuffer, ledBuffer + numLEDs);
+
     // Stop timing the update effects
-    timeProfiler.stop(profilerKey);
+    timeProfiler.stop(profilerId);
 
     // Release mutex after buffer access
     xSemaphoreGive(segmentMutex);
   }
 }
 
-void LEDSegment::draw()
+void LEDSegment::renderBottom(LEDEffect *effect)
 {
-  if (xSemaphoreTake(segmentMutex, portMAX_DELAY) == pdTRUE)
+  // Only a layer that hides everything below draws the same pixels on every
+  // segment alike, and only worth keeping if there is another
+  LEDEffect::SharedRender &shared = effect->shared;
+  bool shareable = false;
+  bool drawnAlike = false; // the last shared render came from a segment like this one
+  if (coversAll && shared.colors.size() >= numLEDs && !effect->drawsByPosition(this))
+    for (const LEDSegment *other : effect->segments)
+      if (other != this && drawsLike(other, effect))
+      {
+        shareable = true;
+        drawnAlike |= other == shared.drawnBy;
+      }
+
+  if (!shareable)
   {
-    // if (allBlack(ledBuffer, numLEDs))
-    //   return;
+    effect->render(this, ledBuffer);
+    // A symmetric bottom layer drew the first half, the layers above see all of it
+    if (mirrorBottom)
+      mirrorHalf();
+    return;
+  }
+
+  // Effects only look at the symmetry when they draw half
+  uint32_t frame = LEDEffect::getFrame().frame;
+  uint16_t drawnLength = mirrorBottom ? getHalfLength() : numLEDs;
+  parentStrip->shareableRenders++;
+
+  if (drawnAlike && shared.frame == frame && shared.drawnLength == drawnLength)
+  {
+    memcpy(ledBuffer, shared.colors.data(), numLEDs * sizeof(Color));
+    parentStrip->sharedRenders++;
+    return;
+  }
 
-    uint16_t endIndex = startIndex + numLEDs - 1;
-    uint32_t black32 = Color::BLACK.to32Bit();
+  effect->render(this, ledBuffer);
+  if (mirrorBottom)
+    mirrorHalf();
+
+  memcpy(shared.colors.data(), ledBuffer, numLEDs * sizeof(Color));
+  shared.frame = frame;
+  shared.drawnBy = this;
+  shared.drawnLength = drawnLength;
+}
+
+// Effects draw by a segment's length and symmetry, unless they draw it by
+// its place in the layout or tell the two apart themselves
+bool LEDSegment::drawsLike(const LEDSegment *other, const LEDEffect *effect) const
+{
+  return other->numLEDs == numLEDs && !effect->drawsByPosition(other) && effect->drawsAlike(this, other);
+}
+
+// Lay the private buffer over the strip buffer. Its colours are already
+// scaled by their coverage, so only the strip's share needs weighting.
+static inline void composePixel(Color &dst, const Color &src)
+{
+  if (src.w == 255)
+    dst = src;
+  else if (src.w != 0)
+  {
+    uint8_t keep = 255 - src.w;
+    dst.r = std::min(255, src.r + Color::scale(dst.r, keep));
+    dst.g = std::min(255, src.g + Color::scale(dst.g, keep));
+    dst.b = std::min(255, src.b + Color::scale(dst.b, keep));
+    dst.w = std::min(255, src.w + Color::scale(dst.w, keep));
+  }
+}
+
+void LEDSegment::compose()
+{
+  Color *dest = parentStrip->ledBuffer + startIndex;
+
+  if (!fliped)
+  {
     for (uint16_t i = 0; i < numLEDs; i++)
-    {
+      composePixel(dest[i], ledBuffer[i]);
+  }
+  else
+  {
+    Color *end = dest + numLEDs - 1;
+    for (uint16_t i = 0; i < numLEDs; i++)
+      composePixel(*(end - i), ledBuffer[i]);
+  }
+}
 
-      if (!fliped) // Normal order. copy to parent strip
-      {
-        if (ledBuffer[i].to32Bit() != black32)
-          parentStrip->ledBuffer[startIndex + i] = ledBuffer[i];
-      }
-      else
-      { // Fliped order. copy to parent strip in reverse order
-        if (ledBuffer[endIndex - i].to32Bit() != black32)
-          parentStrip->ledBuffer[endIndex - i] = ledBuffer[i];
-      }
-    }
+void LEDSegment::setComposited(bool _composited)
+{
+  composited = _composited;
 
-    xSemaphoreGive(segmentMutex);
+  // The compose buffer is kept once allocated, arena memory is not reused
+  if (composited)
+  {
+    if (!composeBuffer)
+      composeBuffer = ledArena.allocate<Color>(numLEDs, ArenaPlacement::INTERNAL, name + " compose");
+    ledBuffer = composeBuffer;
   }
+  else
+    ledBuffer = parentStrip->ledBuffer + startIndex;
+}
+
+bool LEDSegment::isComposited()
+{
+  return composited;
+}
+
+bool LEDSegment::overlaps(const LEDSegment *other) const
+{
+  return startIndex < other->startIndex + other->numLEDs &&
+         other->startIndex < startIndex + numLEDs;
 }
 
 void LEDSegment::clearBuffer()
@@ -378,7 +427,7 @@ void LEDSegment::clearBuffer()
 
 void LEDSegment::clearBufferUnsafe()
 {
-  memset(ledBuffer, 0, numLEDs * sizeof(Color));
+  memset(getBuffer(), 0, numLEDs * sizeof(Color));
 }
 
 LEDStrip::LEDStrip(String _name, uint16_t _numLEDs, uint8_t _ledPin)
@@ -387,17 +436,23 @@ LEDStrip::LEDStrip(String _name, uint16_t _numLEDs, uint8_t _ledPin)
   numLEDs = _numLEDs;
   ledPin = _ledPin;
   brightness = 255;
+  dirty = true;
+  frameHash = 0;
+  lastShowTime = 0;
+  keepAliveInterval = 1000;
+  suppressedShows = 0;
+  sharedRenders = 0;
+  shareableRenders = 0;
   isEnabled = true;
   isActive = false;
   fliped = false;
   type = LEDStripType::NONE;
 
   bufferMutex = xSemaphoreCreateMutex();
+  profilerId = PROFILER_INVALID_ID;
 
-  leds = new CRGB[numLEDs]; // fastled buffer
-  memset(leds, 0, numLEDs * sizeof(CRGB));
-  ledBuffer = new Color[numLEDs]; // internal buffer
-  memset(ledBuffer, 0, numLEDs * sizeof(Color));
+  ledBuffer = ledArena.allocate<Color>(numLEDs, ArenaPlacement::INTERNAL, name + " render"); // render buffer
+  frames = new FrameQueue(numLEDs, name); // finished frames, shown by FastLED in place
 
   _initController();
 
@@ -409,13 +464,42 @@ LEDStrip::LEDStrip(String _name, uint16_t _numLEDs, uint8_t _ledPin)
 
 LEDStrip::~LEDStrip()
 {
+  // Segments detach themselves from their effects and from this strip
+  std::vector<LEDSegment *> ownSegments = segments;
+  for (auto segment : ownSegments)
+    delete segment;
+  mainSegment = nullptr;
+
   if (bufferMutex != nullptr)
   {
     vSemaphoreDelete(bufferMutex);
   }
 
-  delete[] leds;
-  delete[] ledBuffer;
+  ledArena.release(ledBuffer);
+  delete frames;
+}
+
+void LEDStrip::updateSegmentLayout()
+{
+  if (xSemaphoreTake(bufferMutex, portMAX_DELAY) != pdTRUE)
+    return;
+
+  // A segment only needs its own buffer if an earlier segment with effects
+  // already renders into part of its range. Segments without effects render
+  // nothing and never claim a range.
+  for (size_t i = 0; i < segments.size(); i++)
+  {
+    LEDSegment *segment = segments[i];
+    bool overlapped = false;
+
+    if (!segment->effects.empty())
+      for (size_t j = 0; j < i && !overlapped; j++)
+        overlapped = !segments[j]->effects.empty() && segments[j]->overlaps(segment);
+
+    segment->setComposited(overlapped);
+  }
+
+  xSemaphoreGive(bufferMutex);
 }
 
 void LEDStrip::addEffect(LEDEffect *effect)
@@ -438,55 +522,99 @@ void LEDStrip::removeEffect(LEDEffect *effect)
   mainSegment->removeEffect(effect);
 }
 
-void LEDStrip::updateEffects()
+void LEDStrip::renderEffects()
 {
   // Take mutex before accessing buffer
   if (xSemaphoreTake(bufferMutex, portMAX_DELAY) == pdTRUE)
   {
     // Start timing the update effects
-    String profilerKey = name + "_UpdateEffects";
-    timeProfiler.start(profilerKey);
+    if (profilerId == PROFILER_INVALID_ID)
+      profilerId = timeProfiler.registerKey(name + "_RenderEffects");
+    timeProfiler.start(profilerId);
 
-    clearBufferUnsafe();
+    // The clear is wasted if an in-place segment over the whole strip has a
+    // bottom layer that overwrites every pixel
+    bool covered = false;
+    if (isEnabled && isActive)
+      for (auto segment : segments)
+      {
+        segment->planLayers();
+        covered |= !segment->composited && segment->startIndex == 0 && segment->numLEDs == numLEDs &&
+                   segment->coversAll;
+      }
+
+    if (!covered)
+      clearBufferUnsafe();
 
     if (isEnabled && isActive)
       for (auto segment : segments)
       {
-        segment->updateEffects();
+        segment->renderEffects();
       }
 
-    timeProfiler.stop(profilerKey);
+    publishFrameUnsafe();
+
+    timeProfiler.stop(profilerId);
 
     xSemaphoreGive(bufferMutex);
   }
 }
 
-void LEDStrip::draw()
+void LEDStrip::publishFrame()
 {
   if (xSemaphoreTake(bufferMutex, portMAX_DELAY) == pdTRUE)
   {
+    publishFrameUnsafe();
+    xSemaphoreGive(bufferMutex);
+  }
+}
 
-    if (!isEnabled)
-      return;
-
-    if (isActive)
-      for (auto segment : segments)
-      {
-        segment->draw();
-      }
+// The only pass over the finished frame: drop the coverage byte, apply the
+// strip orientation and fingerprint the pixels for show suppression.
+void LEDStrip::publishFrameUnsafe()
+{
+  CRGB *frame = frames->getBack();
 
-    if (!fliped)
+  // FNV-1a over the orientation and whole pixels, folded into the copy so it
+  // costs no extra pass
+  uint32_t hash = (2166136261u ^ fliped) * 16777619u;
+  if (!fliped)
+  {
+    for (uint16_t i = 0; i < numLEDs; i++)
     {
-      for (uint16_t i = 0; i < numLEDs; i++)
-        leds[i] = CRGB(ledBuffer[i].r, ledBuffer[i].g, ledBuffer[i].b);
+      frame[i] = CRGB(ledBuffer[i].r, ledBuffer[i].g, ledBuffer[i].b);
+      hash = (hash ^ (ledBuffer[i].to32Bit() & 0x00FFFFFF)) * 16777619u;
     }
-    else
+  }
+  else
+  {
+    for (uint16_t i = 0; i < numLEDs; i++)
     {
-      for (uint16_t i = 0; i < numLEDs; i++)
-        leds[numLEDs - 1 - i] = CRGB(ledBuffer[i].r, ledBuffer[i].g, ledBuffer[i].b);
+      frame[numLEDs - 1 - i] = CRGB(ledBuffer[i].r, ledBuffer[i].g, ledBuffer[i].b);
+      hash = (hash ^ (ledBuffer[i].to32Bit() & 0x00FFFFFF)) * 16777619u;
     }
+  }
 
-    xSemaphoreGive(bufferMutex);
+  frames->publish(hash);
+}
+
+// Runs on the LED task. Lock-free and O(1): the controller shows the front
+// slot directly.
+void LEDStrip::draw()
+{
+  if (!isEnabled)
+    return;
+
+  // A repeated frame is already what the controller points at
+  if (!frames->acquire())
+    return;
+
+  controller->setLeds(frames->getFront(), numLEDs);
+
+  if (frames->getFrontHash() != frameHash)
+  {
+    frameHash = frames->getFrontHash();
+    dirty = true;
   }
 }
 
@@ -495,28 +623,58 @@ void LEDStrip::show()
   // if (xSemaphoreTake(fastledMutex, portMAX_DELAY) == pdPASS)
   // {
   controller->showLeds(brightness);
+  dirty = false;
+  lastShowTime = millis();
 
   // xSemaphoreGive(fastledMutex);
   // }
 }
 
+bool LEDStrip::needsShow()
+{
+  if (dirty || keepAliveInterval == 0 || millis() - lastShowTime >= keepAliveInterval)
+    return true;
+
+  suppressedShows++;
+  return false;
+}
+
+void LEDStrip::setKeepAliveInterval(uint16_t intervalMs) { keepAliveInterval = intervalMs; }
+
+uint16_t LEDStrip::getKeepAliveInterval() const { return keepAliveInterval; }
+
+uint32_t LEDStrip::getSuppressedShows() const { return suppressedShows; }
+
 String LEDStrip::getName() { return name; }
 
-CRGB *LEDStrip::getFastLEDBuffer() { return leds; }
+CRGB *LEDStrip::getFastLEDBuffer() { return frames->getFront(); }
 
 Color *LEDStrip::getBuffer() { return ledBuffer; }
 
+const CRGB *LEDStrip::getLastFrame() { return frames->getLastPublished(); }
+
 void LEDStrip::clearBuffer()
 {
   if (xSemaphoreTake(bufferMutex, portMAX_DELAY) == pdTRUE)
   {
-    clearBufferUnsafe();
     for (auto segment : segments)
       segment->clearBuffer();
+    clearBufferUnsafe();
+    publishFrameUnsafe(); // show the cleared strip without waiting for the next update
     xSemaphoreGive(bufferMutex);
   }
 }
 
+uint32_t LEDStrip::getPublishedFrames() const { return frames->getPublishedFrames(); }
+
+uint32_t LEDStrip::getDroppedFrames() const { return frames->getDroppedFrames(); }
+
+uint32_t LEDStrip::getRepeatedFrames() const { return frames->getRepeatedFrames(); }
+
+uint32_t LEDStrip::getSharedRenders() const { return sharedRenders; }
+
+uint32_t LEDStrip::getShareableRenders() const { return shareableRenders; }
+
 void LEDStrip::clearBufferUnsafe()
 {
   memset(ledBuffer, 0, numLEDs * sizeof(Color));
@@ -528,13 +686,15 @@ uint16_t LEDStrip::getNumLEDs() const { return numLEDs; }
 
 void LEDStrip::setFliped(bool _fliped)
 {
-  fliped = _fliped;
+  fliped = _fliped; // applied by the next published frame
 }
 
 bool LEDStrip::getFliped() { return fliped; };
 
 void LEDStrip::setBrightness(uint8_t brightness)
 {
+  if (this->brightness != brightness)
+    dirty = true;
   this->brightness = brightness;
 }
 
@@ -608,67 +768,67 @@ void LEDStrip::_initController()
   switch (ledPin)
   {
   case 1:
-    controller = &FastLED.addLeds<WS2812B, 1, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 1, GRB>(frames->getFront(), numLEDs);
     break;
   case 2:
-    controller = &FastLED.addLeds<WS2812B, 2, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 2, GRB>(frames->getFront(), numLEDs);
     break;
   case 3:
-    controller = &FastLED.addLeds<WS2812B, 3, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 3, GRB>(frames->getFront(), numLEDs);
     break;
   case 4:
-    controller = &FastLED.addLeds<WS2812B, 4, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 4, GRB>(frames->getFront(), numLEDs);
     break;
   case 5:
-    controller = &FastLED.addLeds<WS2812B, 5, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 5, GRB>(frames->getFront(), numLEDs);
     break;
   case 6:
-    controller = &FastLED.addLeds<WS2812B, 6, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 6, GRB>(frames->getFront(), numLEDs);
     break;
   case 7:
-    controller = &FastLED.addLeds<WS2812B, 7, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 7, GRB>(frames->getFront(), numLEDs);
     break;
   case 8:
-    controller = &FastLED.addLeds<WS2812B, 8, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 8, GRB>(frames->getFront(), numLEDs);
     break;
   case 9:
-    controller = &FastLED.addLeds<WS2812B, 9, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 9, GRB>(frames->getFront(), numLEDs);
     break;
   case 10:
-    controller = &FastLED.addLeds<WS2812B, 10, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 10, GRB>(frames->getFront(), numLEDs);
     break;
   case 11:
-    controller = &FastLED.addLeds<WS2815, 11, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2815, 11, GRB>(frames->getFront(), numLEDs);
     break;
   case 12:
-    controller = &FastLED.addLeds<WS2812B, 12, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 12, GRB>(frames->getFront(), numLEDs);
     break;
   case 13:
-    controller = &FastLED.addLeds<WS2812B, 13, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 13, GRB>(frames->getFront(), numLEDs);
     break;
   case 14:
-    controller = &FastLED.addLeds<WS2812B, 14, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 14, GRB>(frames->getFront(), numLEDs);
     break;
   case 15:
-    controller = &FastLED.addLeds<WS2812B, 15, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 15, GRB>(frames->getFront(), numLEDs);
     break;
   case 16:
-    controller = &FastLED.addLeds<WS2812B, 16, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 16, GRB>(frames->getFront(), numLEDs);
     break;
   case 17:
-    controller = &FastLED.addLeds<WS2812B, 17, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 17, GRB>(frames->getFront(), numLEDs);
     break;
   case 18:
-    controller = &FastLED.addLeds<WS2812B, 18, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 18, GRB>(frames->getFront(), numLEDs);
     break;
   case 19:
-    controller = &FastLED.addLeds<WS2812B, 19, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 19, GRB>(frames->getFront(), numLEDs);
     break;
   case 20:
-    controller = &FastLED.addLeds<WS2812B, 20, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 20, GRB>(frames->getFront(), numLEDs);
     break;
   case 21:
-    controller = &FastLED.addLeds<WS2812B, 21, GRB>(leds, numLEDs);
+    controller = &FastLED.addLeds<WS2812B, 21, GRB>(frames->getFront(), numLEDs);
     break;
   }
 }
\ No newline at end of file
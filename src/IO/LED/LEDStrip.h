@@ -2,18 +2,16 @@
 
 #include <stdint.h>
 #include <vector>
+#include <atomic>
+#include "Color.h"
 #include "Effects.h"
 #include <Arduino.h>
 #include "FastLED.h"
 #include "../TimeProfiler.h"
+#include "FrameQueue.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 
-// ####################################
-//  Uncomment this line to use double buffering for more complex transparent effects.
-// #define USE_2_BUFFERS
-// ####################################
-
 class LEDEffect; // Forward declaration of effect class
 class LEDStrip;
 
@@ -27,83 +25,39 @@ enum class LEDStripType
   INTERIOR,
   // Add more types as needed
 };
-struct Color
+
+// How a segment's second half relates to its first. Effects that support it
+// draw only getHalfLength() LEDs and the segment mirrors them.
+enum class SegmentSymmetry : uint8_t
 {
-  uint8_t r;
-  uint8_t g;
-  uint8_t b;
-  uint8_t w;
-
-  Color() : r(0), g(0), b(0), w(0) {}
-  Color(uint8_t red, uint8_t green, uint8_t blue)
-      : r(red), g(green), b(blue), w(0) {}
-  Color(uint8_t red, uint8_t green, uint8_t blue, uint8_t white)
-      : r(red), g(green), b(blue), w(white) {}
-
-  static Color hsv2rgb(float h, float s, float v);
-  static Color rgb2hsv(uint8_t r, uint8_t g, uint8_t b);
-
-  uint32_t to32Bit() const;
-
-  static const Color WHITE;
-  static const Color BLACK;
-  static const Color RED;
-  static const Color ORANGE;
-  static const Color GREEN;
-  static const Color BLUE;
-  static const Color YELLOW;
-  static const Color CYAN;
-  static const Color MAGENTA;
-
-  bool operator==(const Color &other) const
-  {
-    return r == other.r && g == other.g && b == other.b && w == other.w;
-  }
-
-  bool operator!=(const Color &other) const
-  {
-    return !(*this == other);
-  }
-
-  /**
-   * @brief Multiplies the color by a scalar value
-   * @param scalar A floating-point value between 0 and 1
-   * @return A new Color object with RGBW components scaled by the scalar value
-   */
-  Color operator*(float scalar) const
-  {
-    return Color(r * scalar, g * scalar, b * scalar, w * scalar);
-  }
-
-  void print() const;
-  static void print(const Color &color);
-  static void print(const Color *colors, uint16_t numLEDs);
-  static void print(const CRGB *colors, uint16_t numLEDs);
+  NONE,
+  MIRROR,        // LED i matches numLEDs - 1 - i, odd lengths have a centre LED
+  MIRROR_CENTER, // mirrored around LED numLEDs / 2, even lengths leave LED 0 unpaired
 };
 
-// [[gnu::always_inline]]
-// bool allBlack(const Color *colors, uint16_t numLEDs) noexcept
-// {
-//   const uint32_t black32 = Color::BLACK.to32Bit();
-
-//   for (uint16_t i = 0; i < numLEDs; ++i)
-//   {
-//     if (colors[i].to32Bit() != black32)
-//     {
-//       return false;
-//     }
-//   }
-//   return true; // every element was black
-// }
-
+// A segment is a view into its parent strip's buffer. Effects render straight
+// into the strip buffer, lowest priority first, each blending its pixels over
+// what is already there. If an earlier segment with effects overlaps this one,
+// the segment renders into its own buffer and is composed on top using the
+// accumulated alpha. Layers hidden under an effect that covers the whole
+// segment opaquely are not rendered at all, and such a bottom layer that a
+// segment of the same shape already drew this frame is copied from it.
 class LEDSegment
 {
 private:
-  Color *ledBuffer;
+  Color *ledBuffer;     // points into parentStrip->ledBuffer, or at composeBuffer
+  Color *composeBuffer; // allocated the first time the segment needs composing
+  bool composited;
   uint16_t numLEDs;
   LEDStrip *parentStrip;
 
   std::vector<LEDEffect *> effects;
+  std::vector<LEDEffect *> liveEffects; // the live ones, in priority order
+  std::atomic<bool> liveChanged;        // an effect woke up or went idle since liveEffects was built
+  std::vector<LEDEffect *> layers;      // effects drawn this frame, capacity kept for all of them
+  bool coversAll;                  // the bottom layer hides everything, no clear needed
+  bool mirrorBottom;               // the bottom layer drew half, mirror it before the next one
+  SegmentSymmetry symmetry;
 
 public:
   LEDSegment(LEDStrip *_parentStrip, String _name, uint16_t _startIndex, uint16_t _numLEDs);
@@ -111,8 +65,8 @@ public:
   ~LEDSegment();
 
   Color *getBuffer();
-  uint16_t getNumLEDs();
-  LEDStrip *getParentStrip();
+  uint16_t getNumLEDs() const;
+  LEDStrip *getParentStrip() const;
   void setEnabled(bool enabled);
   bool getEnabled();
 
@@ -120,13 +74,20 @@ public:
   void removeEffect(LEDEffect *effect);
   uint16_t effectCount();
 
-  void updateEffects();
+  void setSymmetry(SegmentSymmetry symmetry);
+  SegmentSymmetry getSymmetry() const;
+  bool isSymmetric() const;
+  // LEDs an effect draws on a symmetric segment, the centre LED included
+  uint16_t getHalfLength() const;
+
+  void renderEffects();
 
-  void draw();
   void clearBuffer();
+  bool isComposited();
 
   // Mutex for segment buffer access
   SemaphoreHandle_t segmentMutex;
+  ProfilerId profilerId; // renderEffects() timing
 
   String name;
   uint16_t startIndex;
@@ -134,8 +95,22 @@ public:
   bool fliped;
 
 private:
+  friend class LEDStrip;
+  friend class LEDEffect; // marks liveChanged
+
   // Private buffer clear without mutex (for internal use)
   void clearBufferUnsafe();
+
+  void setComposited(bool composited);
+  void compose();
+  void mirrorHalf(); // copy the first half onto the second
+  void renderBottom(LEDEffect *effect); // layer 0, copied if a segment of the same shape drew it
+  bool drawsLike(const LEDSegment *other, const LEDEffect *effect) const;
+
+  // Pick the layers that will be seen this frame, before anything is cleared
+  void planLayers();
+  void collectLiveEffects();
+  bool overlaps(const LEDSegment *other) const;
 };
 
 class LEDStrip
@@ -148,17 +123,36 @@ public:
   void addEffect(LEDEffect *effect);
   void removeEffect(LEDEffect *effect);
 
-  void updateEffects();
+  // === APP LOOP (producer) ===
+  void renderEffects(); // render the effects of every segment and publish the frame
+  void publishFrame();  // convert the buffer into a frame for the LED task
 
-  void draw(); // copy the buffer to the FastLED buffer
-  void show(); // show the FastLED buffer
+  // === LED TASK (consumer) ===
+  void draw();      // point the controller at the newest published frame
+  void show();      // show the FastLED buffer
+  bool needsShow(); // false if the strip already shows this content (counts as suppressed)
+
+  // Unchanged frames are still re-sent this often (ms). 0 shows every frame.
+  void setKeepAliveInterval(uint16_t intervalMs);
+  uint16_t getKeepAliveInterval() const;
+  uint32_t getSuppressedShows() const;
 
   String getName();
 
-  CRGB *getFastLEDBuffer();
-  Color *getBuffer();
+  CRGB *getFastLEDBuffer();      // frame the controller shows (LED task side)
+  Color *getBuffer();            // frame being rendered
+  const CRGB *getLastFrame();    // last published frame, in strip order
   void clearBuffer();
 
+  uint32_t getPublishedFrames() const;
+  uint32_t getDroppedFrames() const;
+  uint32_t getRepeatedFrames() const;
+
+  // Bottom layers copied from another segment that drew them earlier in the
+  // frame, out of all the ones that could have been
+  uint32_t getSharedRenders() const;
+  uint32_t getShareableRenders() const;
+
   LEDStripType getType() const;
 
   uint16_t getNumLEDs() const;
@@ -180,8 +174,9 @@ public:
   void setActive(bool active);
   bool getActive() const;
 
-  // Public mutex for external buffer access
+  // Serialises writers of the render buffer. The LED task never takes it.
   SemaphoreHandle_t bufferMutex;
+  ProfilerId profilerId; // renderEffects() timing
 
   CLEDController *controller;
 
@@ -190,7 +185,8 @@ private:
   friend class LEDSegment;
   LEDStripType type;
   uint16_t numLEDs;
-  Color *ledBuffer;
+  FrameQueue *frames;
+  Color *ledBuffer; // render target, RGB plus coverage in w for blending
   LEDSegment *mainSegment;
   std::vector<LEDSegment *> segments;
   String name;
@@ -201,11 +197,25 @@ private:
   bool fliped;
 
   uint8_t ledPin;
-  CRGB *leds;
   uint8_t brightness;
 
+  // Show suppression, only touched by the LED task (dirty is also set by setBrightness)
+  bool dirty;             // the front frame differs from what was last shown
+  uint32_t frameHash;     // fingerprint of the last drawn frame
+  uint32_t lastShowTime;  // millis() of the last show
+  uint16_t keepAliveInterval;
+  uint32_t suppressedShows;
+
+  // Shared bottom layer counts, only touched by the render task
+  uint32_t sharedRenders;
+  uint32_t shareableRenders;
+
   void _initController();
 
-  // Private buffer clear without mutex (for internal use)
+  // Decide which segments render in place and which need composing
+  void updateSegmentLayout();
+
+  // Private buffer clear and publish without mutex (for internal use)
   void clearBufferUnsafe();
+  void publishFrameUnsafe();
 };
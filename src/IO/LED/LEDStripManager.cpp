@@ -1,10 +1,10 @@
 #include "LEDStripManager.h"
 #include "LEDStrip.h" // Include this for full definitions
-#include "../../config.h"
 #include <Arduino.h>
 #include <set> // Add include for std::set
 #include <map>
 #include "IO/TimeProfiler.h"
+#include "IO/TraceRecorder.h"
 
 // Initialize static instance pointer
 LEDStripManager *LEDStripManager::instance = nullptr;
@@ -22,7 +22,8 @@ LEDStripManager::LEDStripManager()
 {
   // Store this instance in the static pointer for callbacks to use
   instance = this;
-  drawFPS = 200;
+  drawFPS = LED_DRAW_FPS;
+  frameDeadline.setPeriodUs(1000000 / drawFPS);
   ledTaskHandle = NULL;
   taskRunning = false;
 }
@@ -67,11 +68,11 @@ std::map<LEDStripType, LEDStripConfig> LEDStripManager::getStrips()
   return strips;
 }
 
-Color *LEDStripManager::getStripBuffer(LEDStripType type)
+const CRGB *LEDStripManager::getStripBuffer(LEDStripType type)
 {
   if (strips.find(type) != strips.end() && strips[type].strip)
   {
-    return strips[type].strip->getBuffer();
+    return strips[type].strip->getLastFrame();
   }
   return nullptr;
 }
@@ -118,6 +119,14 @@ void LEDStripManager::addLEDStrip(const LEDStripConfig &config)
 
   // Add to the map of strips
   strips[config.type] = config;
+
+  // Register the draw() profiler keys now so the LED task only uses ids
+  LEDStripConfig &added = strips[config.type];
+  added.drawProfilerId = timeProfiler.registerKey("draw-" + added.name);
+  added.showProfilerId = timeProfiler.registerKey("show-" + added.name);
+  added.showSuppressedProfilerId = timeProfiler.registerKey("showSuppressed-" + added.name);
+  added.showTraceName = "show-" + added.name;
+  added.deadline.setPeriodUs(frameDeadline.getPeriodUs());
   // strips[config.type].strip->clearBuffer();
   // Serial.println("LEDStripManager::addLEDStrip: Setting FPS to " + String(drawFPS));
   // strips[config.type].strip->setFPS(drawFPS);
@@ -136,11 +145,14 @@ void LEDStripManager::setBrightness(uint8_t brightness)
 
 void LEDStripManager::updateEffects()
 {
+  // Advance every effect once, then render it into each segment it is on
+  LEDEffect::updateAll();
+
   for (auto &pair : strips)
   {
     if (pair.second.strip)
     {
-      pair.second.strip->updateEffects();
+      pair.second.strip->renderEffects();
       // Serial.println("Updated effects for strip " + pair.second.name);
       // Color::print(pair.second.strip->getBuffer(), pair.second.strip->getNumLEDs());
     }
@@ -149,23 +161,40 @@ void LEDStripManager::updateEffects()
 
 void LEDStripManager::draw()
 {
-  timeProfiler.start("ledFps", TimeUnit::MICROSECONDS);
-  timeProfiler.increment("ledFps");
+  traceRecorder.beginEvent("LEDStripManager::draw");
+  timeProfiler.start(PROFILER_ID("ledFps"), TimeUnit::MICROSECONDS);
+  timeProfiler.increment(PROFILER_ID("ledFps"));
+  uint32_t frameStart = micros();
 
   // Draw all strips with safety checks
   for (auto &pair : strips)
   {
     if (pair.second.strip) // Check if we should still be running
     {
-      timeProfiler.start("draw-" + pair.second.name, TimeUnit::MICROSECONDS);
-      timeProfiler.increment("draw-" + pair.second.name);
-      pair.second.strip->draw();
-      timeProfiler.stop("draw-" + pair.second.name);
-
-      timeProfiler.start("show-" + pair.second.name, TimeUnit::MICROSECONDS);
-      timeProfiler.increment("show-" + pair.second.name);
-      pair.second.strip->show();
-      timeProfiler.stop("show-" + pair.second.name);
+      LEDStripConfig &config = pair.second;
+      uint32_t stripStart = micros(); // the strips before this one are not its time
+
+      timeProfiler.start(config.drawProfilerId, TimeUnit::MICROSECONDS);
+      timeProfiler.increment(config.drawProfilerId);
+      config.strip->draw();
+      timeProfiler.stop(config.drawProfilerId);
+
+      // Static content (parked car, solid colour) does not need re-sending
+      if (config.strip->needsShow())
+      {
+        timeProfiler.start(config.showProfilerId, TimeUnit::MICROSECONDS);
+        timeProfiler.increment(config.showProfilerId);
+        traceRecorder.beginEvent(config.showTraceName.c_str());
+        config.strip->show();
+        traceRecorder.endEvent(config.showTraceName.c_str());
+        timeProfiler.stop(config.showProfilerId);
+      }
+      else
+      {
+        timeProfiler.increment(config.showSuppressedProfilerId);
+      }
+
+      config.deadline.frameDone(stripStart, micros());
     }
     // else
     // {
@@ -173,12 +202,42 @@ void LEDStripManager::draw()
     // }
   }
 
-  // timeProfiler.start("show", TimeUnit::MICROSECONDS);
-  // timeProfiler.increment("show");
+  // timeProfiler.start(PROFILER_ID("show"), TimeUnit::MICROSECONDS);
+  // timeProfiler.increment(PROFILER_ID("show"));
   // FastLED.show();
-  // timeProfiler.stop("show");
+  // timeProfiler.stop(PROFILER_ID("show"));
 
-  timeProfiler.stop("ledFps");
+  frameDeadline.frameDone(frameStart, micros());
+
+  timeProfiler.stop(PROFILER_ID("ledFps"));
+  traceRecorder.endEvent("LEDStripManager::draw");
+}
+
+const FrameDeadline &LEDStripManager::getFrameDeadline() const
+{
+  return frameDeadline;
+}
+
+const FrameDeadline *LEDStripManager::getStripDeadline(LEDStripType type) const
+{
+  auto it = strips.find(type);
+  if (it == strips.end())
+    return nullptr;
+  return &it->second.deadline;
+}
+
+void LEDStripManager::resetFrameDeadlines()
+{
+  frameDeadline.reset();
+  for (auto &pair : strips)
+    pair.second.deadline.reset();
+}
+
+void LEDStripManager::setFramePeriodUs(uint32_t periodUs)
+{
+  frameDeadline.setPeriodUs(periodUs);
+  for (auto &pair : strips)
+    pair.second.deadline.setPeriodUs(periodUs);
 }
 
 // Task management functions
@@ -280,49 +339,43 @@ void LEDStripManager::ledTask(void *parameter)
     Serial.println("[LEDTask] WARNING: Frame period too short, clamped to 1ms");
   }
 
+  // Deadlines are checked against the period we can actually pace at
+  manager->setFramePeriodUs(framePeriodTicks * portTICK_PERIOD_MS * 1000);
+
   Serial.print("[LEDTask] LEDStripManager: Task loop started with FPS: ");
   Serial.println(manager->drawFPS);
 
+  TickType_t lastWakeTime = xTaskGetTickCount();
+
   while (manager->taskRunning)
   {
-    TickType_t startTime = xTaskGetTickCount();
+    uint32_t worstOverrun = manager->frameDeadline.getWorstOverrunUs();
 
     manager->draw(); // draws buffers and shows them
 
-    TickType_t endTime = xTaskGetTickCount();
-    TickType_t elapsedTime = endTime - startTime;
-
     if (!manager->taskRunning)
     {
       break;
     }
 
-    if (framePeriodTicks > 0)
+    // Only report new worst cases so a struggling loop doesn't flood Serial
+    if (manager->frameDeadline.getWorstOverrunUs() > worstOverrun)
     {
-      TickType_t timeToDelay = framePeriodTicks - elapsedTime;
-
-      if (timeToDelay < 0)
-      {
-        Serial.print("[LEDTask] WARNING: Draw took ");
-        Serial.print((float)elapsedTime * (1000.0f / configTICK_RATE_HZ));
-        Serial.print("ms, longer than frame period (");
-        Serial.print((float)framePeriodTicks * (1000.0f / configTICK_RATE_HZ));
-        Serial.println("ms). Frame rate may drop.");
-        timeToDelay = pdMS_TO_TICKS(1);
-      }
-
-      if (timeToDelay > 0 && timeToDelay < pdMS_TO_TICKS(1000))
-        vTaskDelay(timeToDelay);
-      else
-        vTaskDelay(pdMS_TO_TICKS(1));
-    }
-    else
-    {
-      vTaskDelay(pdMS_TO_TICKS(10)); // Longer delay if draw failed to prevent tight loop
+      Serial.print("[LEDTask] WARNING: Frame overran its ");
+      Serial.print(manager->frameDeadline.getPeriodUs());
+      Serial.print("us period by ");
+      Serial.print(manager->frameDeadline.getWorstOverrunUs());
+      Serial.println("us. Frame rate may drop.");
     }
 
-    // Yield to watchdog and other tasks periodically
-    taskYIELD();
+    // If we are already a whole period behind, drop the missed slots instead
+    // of drawing a burst of late frames, and still sleep a tick so lower
+    // priority tasks on this core get to run.
+    TickType_t now = xTaskGetTickCount();
+    if (now - lastWakeTime >= framePeriodTicks)
+      lastWakeTime = now - framePeriodTicks + 1;
+
+    vTaskDelayUntil(&lastWakeTime, framePeriodTicks);
   }
 
   // Clean up when task ends
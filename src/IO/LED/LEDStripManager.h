@@ -1,12 +1,18 @@
 #pragma once
 
 #include "LEDStrip.h"
+#include "FrameDeadline.h"
 // #include "FastLED.h"
 #include <map>
 #include <string>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+// Frame cadences. The app loop updates effects and publishes a frame per strip
+// at LED_UPDATE_FPS; LEDStripTask draws the newest published frame at LED_DRAW_FPS.
+#define LED_UPDATE_FPS 100
+#define LED_DRAW_FPS 200
+
 // Structure to store LED strip configuration
 struct LEDStripConfig
 {
@@ -14,6 +20,15 @@ struct LEDStripConfig
   LEDStrip *strip; // Pointer to the LEDManager for this strip
   String name;     // Human-readable name for the strip
 
+  // Profiler keys used by LEDStripManager::draw(), registered by addLEDStrip()
+  ProfilerId drawProfilerId = PROFILER_INVALID_ID;
+  ProfilerId showProfilerId = PROFILER_INVALID_ID;
+  ProfilerId showSuppressedProfilerId = PROFILER_INVALID_ID;
+  String showTraceName; // TraceRecorder event name for show()
+
+  // Deadline for this strip's show() within the draw frame
+  FrameDeadline deadline;
+
   // Default constructor
   LEDStripConfig() : type(LEDStripType::NONE), strip(nullptr), name("") {}
 
@@ -57,8 +72,8 @@ public:
   LEDStrip *getStrip(LEDStripType type);
   std::map<LEDStripType, LEDStripConfig> getStrips();
 
-  // Get the LED buffer for a specific strip type
-  Color *getStripBuffer(LEDStripType type);
+  // Get the last published frame for a specific strip type
+  const CRGB *getStripBuffer(LEDStripType type);
 
   // Get the number of LEDs for a specific strip type
   uint16_t getStripLEDCount(LEDStripType type);
@@ -74,10 +89,10 @@ public:
   // Set global brightness for all strips
   void setBrightness(uint8_t brightness);
 
-  // update all effects
+  // update all effects once and publish a rendered frame for every strip
   void updateEffects();
 
-  // draw all strips
+  // draw the newest frame of every strip
   void draw();
 
   // Task management functions
@@ -85,6 +100,11 @@ public:
   void stopTask();
   bool isTaskRunning();
 
+  // Frame deadline stats for the whole draw() and for a single strip
+  const FrameDeadline &getFrameDeadline() const;
+  const FrameDeadline *getStripDeadline(LEDStripType type) const;
+  void resetFrameDeadlines();
+
 private:
   // Map of LED strip configurations by type
   std::map<LEDStripType, LEDStripConfig> strips;
@@ -92,6 +112,9 @@ private:
   uint64_t lastDrawTime;
   uint16_t drawFPS;
 
+  FrameDeadline frameDeadline;
+  void setFramePeriodUs(uint32_t periodUs);
+
   // Task-related members
   TaskHandle_t ledTaskHandle;
   bool taskRunning;
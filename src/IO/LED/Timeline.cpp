@@ -0,0 +1,154 @@
+#include "Timeline.h"
+#include <algorithm>
+
+// round(65535 * smoothstep(i / 256)), with the end point so interpolation
+// never reads past the table
+const uint16_t Easing::SMOOTH_TABLE[257] = {
+    0, 3, 12, 27, 47, 74, 106, 144, 188, 237, 292, 353, 418, 490, 567, 649,
+    736, 829, 926, 1029, 1137, 1251, 1369, 1492, 1620, 1753, 1891, 2033, 2180, 2332, 2489, 2650,
+    2816, 2986, 3161, 3340, 3523, 3711, 3903, 4100, 4300, 4504, 4713, 4926, 5142, 5363, 5587, 5816,
+    6048, 6284, 6523, 6767, 7013, 7264, 7518, 7775, 8036, 8300, 8568, 8838, 9112, 9390, 9670, 9953,
+    10240, 10529, 10822, 11117, 11415, 11716, 12020, 12327, 12636, 12948, 13262, 13579, 13898, 14220, 14544, 14871,
+    15200, 15531, 15864, 16200, 16537, 16877, 17219, 17562, 17908, 18255, 18604, 18955, 19308, 19663, 20019, 20376,
+    20736, 21096, 21459, 21822, 22187, 22553, 22921, 23290, 23660, 24031, 24403, 24776, 25150, 25525, 25901, 26278,
+    26656, 27034, 27413, 27793, 28173, 28554, 28935, 29317, 29700, 30082, 30465, 30849, 31232, 31616, 32000, 32384,
+    32768, 33151, 33535, 33919, 34303, 34686, 35070, 35453, 35835, 36218, 36600, 36981, 37362, 37742, 38122, 38501,
+    38879, 39257, 39634, 40010, 40385, 40759, 41132, 41504, 41875, 42245, 42614, 42982, 43348, 43713, 44076, 44439,
+    44799, 45159, 45516, 45872, 46227, 46580, 46931, 47280, 47627, 47973, 48316, 48658, 48998, 49335, 49671, 50004,
+    50335, 50664, 50991, 51315, 51637, 51956, 52273, 52587, 52899, 53208, 53515, 53819, 54120, 54418, 54713, 55006,
+    55295, 55582, 55865, 56145, 56423, 56697, 56967, 57235, 57499, 57760, 58017, 58271, 58522, 58768, 59012, 59251,
+    59487, 59719, 59948, 60172, 60393, 60609, 60822, 61031, 61235, 61435, 61632, 61824, 62012, 62195, 62374, 62549,
+    62719, 62885, 63046, 63203, 63355, 63502, 63644, 63782, 63915, 64043, 64166, 64284, 64398, 64506, 64609, 64706,
+    64799, 64886, 64968, 65045, 65117, 65182, 65243, 65298, 65347, 65391, 65429, 65461, 65488, 65508, 65523, 65532,
+    65535,
+};
+
+TimelinePlayer::TimelinePlayer()
+    : current(nullptr),
+      startMs(0),
+      position(0),
+      started(false),
+      tracks()
+{
+}
+
+void TimelinePlayer::play(const Timeline *timeline, uint16_t _position)
+{
+  current = timeline;
+  position = timeline ? std::min(_position, timeline->duration) : 0;
+  started = false;
+  evaluate();
+}
+
+void TimelinePlayer::update(uint32_t nowMs)
+{
+  if (current == nullptr)
+    return;
+
+  // Anchored on the frame clock here rather than in play(), which may run
+  // before the first frame
+  if (!started)
+  {
+    startMs = nowMs - position;
+    started = true;
+  }
+
+  position = std::min<uint32_t>(nowMs - startMs, current->duration);
+  evaluate();
+}
+
+void TimelinePlayer::evaluate()
+{
+  if (current == nullptr)
+    return;
+
+  for (uint8_t i = 0; i < current->trackCount; i++)
+  {
+    const Track &track = current->tracks[i];
+    TrackState &state = tracks[i];
+
+    uint8_t key = 0;
+    while (key + 1 < track.count && track.keys[key + 1].ms <= position)
+      key++;
+
+    // Before the first keyframe or past the last one the track holds still
+    if (key + 1 >= track.count || position < track.keys[key].ms)
+    {
+      state.from = key;
+      state.to = key;
+      state.weight = 0;
+      continue;
+    }
+
+    const Keyframe &a = track.keys[key];
+    const Keyframe &b = track.keys[key + 1];
+    uint32_t t = ((uint32_t)(position - a.ms) << 16) / (b.ms - a.ms);
+
+    state.from = key;
+    state.to = key + 1;
+    state.weight = Easing::apply(b.ease, t);
+  }
+}
+
+static inline int32_t keyValue(const Keyframe &key, const uint16_t *measures)
+{
+  return (((int32_t)key.amount * measures[key.measure] + 8192) >> 14) + key.leds;
+}
+
+int32_t TimelinePlayer::trackValue(uint8_t index, const uint16_t *measures) const
+{
+  const Track &track = current->tracks[index];
+  const TrackState &state = tracks[index];
+
+  int32_t a = keyValue(track.keys[state.from], measures);
+  if (state.weight == 0)
+    return a;
+
+  int32_t b = keyValue(track.keys[state.to], measures);
+  return a + (((b - a) * state.weight + 32768) >> 16);
+}
+
+uint8_t TimelinePlayer::resolve(const uint16_t *measures, uint16_t numLEDs, TimelineRun *runs) const
+{
+  if (current == nullptr)
+    return 0;
+
+  int32_t half = (numLEDs + 1) / 2;
+  uint8_t count = 0;
+
+  for (uint8_t i = 0; i < current->spanCount; i++)
+  {
+    const TimelineSpan &span = current->spans[i];
+    if (position < span.from || position >= span.to)
+      continue;
+
+    int32_t inner = std::max<int32_t>(0, std::min(half, trackValue(span.inner, measures)));
+    int32_t outer = std::max<int32_t>(0, std::min(half, trackValue(span.outer, measures)));
+    if (outer <= inner)
+      continue;
+
+    runs[count++] = TimelineRun{(uint16_t)inner, (uint16_t)outer, span.level};
+  }
+
+  return count;
+}
+
+void TimelinePlayer::fill(Color *buffer, uint16_t numLEDs, TimelineAnchor anchor, const TimelineRun &run,
+                          const Color &color)
+{
+  Color lit = Color(Color::scale(color.r, run.level), Color::scale(color.g, run.level),
+                    Color::scale(color.b, run.level));
+
+  // Odd lengths share the middle pixel between both halves
+  uint16_t half = (numLEDs + 1) / 2;
+  if (anchor == TimelineAnchor::CENTER)
+  {
+    std::fill(buffer + half - run.end, buffer + half - run.start, lit);
+    std::fill(buffer + numLEDs - half + run.start, buffer + numLEDs - half + run.end, lit);
+  }
+  else
+  {
+    std::fill(buffer + run.start, buffer + run.end, lit);
+    std::fill(buffer + numLEDs - run.end, buffer + numLEDs - run.start, lit);
+  }
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Color.h"
+
+// Keyframed animations (taillight and headlight startup, split and fade) as
+// data. A timeline has tracks of keyframes, each track an edge position that
+// moves over time, and spans that light the pixels between two tracks in a
+// time window. Positions are mirrored around an anchor, so a timeline
+// describes half a segment. A TimelinePlayer evaluates the tracks once per
+// frame and resolves the spans per segment, the only per-pixel work left to
+// the effect is painting them. A new animation is a new table.
+
+enum class Ease : uint8_t
+{
+  HOLD,   // keep the previous value, jump at the keyframe
+  LINEAR,
+  SMOOTH, // smoothstep, 3t^2 - 2t^3
+};
+
+// Where positions are measured from, both halves are drawn mirrored
+enum class TimelineAnchor : uint8_t
+{
+  CENTER, // distance from the middle of the segment
+  ENDS,   // distance from either end
+};
+
+// Keyframe position: amount of a length the effect supplies per segment
+// (measure), plus a fixed number of LEDs
+struct Keyframe
+{
+  uint16_t ms;     // time on the timeline
+  uint16_t amount; // Q14, 16384 is the whole measure
+  uint8_t measure; // index into the effect's measures
+  int8_t leds;
+  Ease ease; // curve from the previous keyframe to this one
+};
+
+constexpr Keyframe keyframe(uint16_t ms, float amount, uint8_t measure = 0, int8_t leds = 0, Ease ease = Ease::LINEAR)
+{
+  return Keyframe{ms, (uint16_t)(amount * 16384.0f + 0.5f), measure, leds, ease};
+}
+
+struct Track
+{
+  const Keyframe *keys;
+  uint8_t count; // a single keyframe is a constant
+};
+
+template <size_t N>
+constexpr Track track(const Keyframe (&keys)[N])
+{
+  return Track{keys, (uint8_t)N};
+}
+
+// Lights [inner, outer) from the anchor while from <= position < to
+struct TimelineSpan
+{
+  uint16_t from;
+  uint16_t to;
+  uint8_t inner; // track index
+  uint8_t outer; // track index
+  uint8_t level; // brightness, 0 is opaque black
+};
+
+// TimelineSpan::to for spans that stay until the next timeline
+static constexpr uint16_t TIMELINE_FOREVER = 0xFFFF;
+
+static constexpr uint8_t TIMELINE_MAX_TRACKS = 8;
+static constexpr uint8_t TIMELINE_MAX_SPANS = 8;
+
+struct Timeline
+{
+  const Track *tracks;
+  uint8_t trackCount;
+  const TimelineSpan *spans;
+  uint8_t spanCount;
+  uint16_t duration; // ms, the last frame holds after it
+  TimelineAnchor anchor;
+};
+
+template <size_t T, size_t S>
+constexpr Timeline timeline(const Track (&tracks)[T], const TimelineSpan (&spans)[S], uint16_t duration,
+                            TimelineAnchor anchor)
+{
+  static_assert(T <= TIMELINE_MAX_TRACKS, "too many tracks");
+  static_assert(S <= TIMELINE_MAX_SPANS, "too many spans");
+  return Timeline{tracks, (uint8_t)T, spans, (uint8_t)S, duration, anchor};
+}
+
+// A span resolved for one segment, in LEDs from the anchor
+struct TimelineRun
+{
+  uint16_t start;
+  uint16_t end;
+  uint8_t level;
+};
+
+// Shared easing curves, fixed point, from a 256 entry table with linear
+// interpolation
+class Easing
+{
+public:
+  // t and the result in Q16, 0 to 65535
+  static inline uint16_t apply(Ease ease, uint16_t t)
+  {
+    switch (ease)
+    {
+    case Ease::HOLD:
+      return 0;
+    case Ease::SMOOTH:
+    {
+      uint8_t index = t >> 8;
+      int32_t fraction = t & 0xFF;
+      int32_t a = SMOOTH_TABLE[index];
+      int32_t b = SMOOTH_TABLE[index + 1];
+      return a + (((b - a) * fraction) >> 8);
+    }
+    default:
+      return t;
+    }
+  }
+
+private:
+  static const uint16_t SMOOTH_TABLE[257];
+};
+
+// Plays a Timeline. Its whole state is the timeline and the position on
+// it, which is all a sync message needs to carry.
+class TimelinePlayer
+{
+public:
+  TimelinePlayer();
+
+  // Start timeline at position (ms) on the next update, nullptr stops
+  void play(const Timeline *timeline, uint16_t position = 0);
+  void stop() { play(nullptr); }
+
+  // Advance to nowMs and evaluate every track, once per frame
+  void update(uint32_t nowMs);
+
+  // Resolve the spans lit at the current position for a segment. measures
+  // are the lengths keyframes refer to, runs needs TIMELINE_MAX_SPANS
+  // entries. Returns the number of runs, in span order.
+  uint8_t resolve(const uint16_t *measures, uint16_t numLEDs, TimelineRun *runs) const;
+
+  // Fill a run on both sides of the anchor with color scaled by its level
+  static void fill(Color *buffer, uint16_t numLEDs, TimelineAnchor anchor, const TimelineRun &run, const Color &color);
+
+  const Timeline *getTimeline() const { return current; }
+  bool isPlaying(const Timeline *timeline) const { return current == timeline; }
+  bool isFinished() const { return current == nullptr || position >= current->duration; }
+  uint16_t getPosition() const { return position; }
+  void setPosition(uint16_t position) { play(current, position); }
+
+private:
+  // Keyframes either side of the position and the eased weight between them
+  struct TrackState
+  {
+    uint8_t from;
+    uint8_t to;
+    uint16_t weight; // Q16
+  };
+
+  const Timeline *current;
+  uint32_t startMs;
+  uint16_t position;
+  bool started; // startMs is set by the first update after play()
+  TrackState tracks[TIMELINE_MAX_TRACKS];
+
+  void evaluate();
+  int32_t trackValue(uint8_t index, const uint16_t *measures) const;
+};
@@ -13,7 +13,7 @@ String NightRiderSyncData::print()
 
 String PoliceSyncData::print()
 {
-  return String("Mode: " + String((int)mode) + ", Flash Progress: " + String(flashProgress) + ", Cycle Progress: " + String(cycleProgress) + ", Current Flash: " + String(currentFlash) + ", Active: " + String(active));
+  return String("Mode: " + String((int)mode) + ", Step: " + String(step) + ", Beat: " + String(beat) + ", Active: " + String(active));
 }
 
 String SolidColorSyncData::print()
@@ -55,7 +55,7 @@ String ServiceLightsSyncData::print()
     modeStr = "UNKNOWN";
     break;
   }
-  return String("Mode: " + modeStr + ", Progress: " + String(progress) + ", Cycle Progress: " + String(cycleProgress) + ", Current Flash: " + String(currentFlash) + ", Fast Speed: " + String(fastSpeed) + ", Slow Speed: " + String(slowSpeed) + ", Flashes Per Cycle: " + String(fastModeFlashesPerCycle) + ", Color: (" + String(colorR) + "," + String(colorG) + "," + String(colorB) + "), Active: " + String(active));
+  return String("Mode: " + modeStr + ", Step: " + String(step) + ", Beat: " + String(beat) + ", Scroll Progress: " + String(scrollProgress) + ", Fast Speed: " + String(fastSpeed) + ", Slow Speed: " + String(slowSpeed) + ", Flashes Per Cycle: " + String(fastModeFlashesPerCycle) + ", Color: (" + String(colorR) + "," + String(colorG) + "," + String(colorB) + "), Active: " + String(active));
 }
 
 void EffectSyncState::print()
@@ -33,9 +33,8 @@ struct __attribute__((packed)) PoliceSyncData
 {
   bool active;
   PoliceMode mode;
-  float flashProgress;
-  float cycleProgress;
-  uint16_t currentFlash;
+  uint8_t step; // FlashSequencer step
+  float beat;   // time into the step in beats
 
   String print();
 };
@@ -110,9 +109,9 @@ struct __attribute__((packed)) ServiceLightsSyncData
 {
   bool active;
   ServiceLightsMode mode;
-  float progress;                   // flashProgress for timing sync
-  float cycleProgress;              // cycleProgress for pattern sync
-  uint16_t currentFlash;            // current flash count for FAST mode
+  uint8_t step;                     // FlashSequencer step
+  float beat;                       // time into the step in beats
+  float scrollProgress;             // position in the SCROLL cycle (0-1)
   float fastSpeed;                  // timing configuration for fast mode
   float slowSpeed;                  // timing configuration for slow/alternate/scroll modes
   uint16_t fastModeFlashesPerCycle; // number of flashes per cycle in fast mode
@@ -121,6 +120,9 @@ struct __attribute__((packed)) ServiceLightsSyncData
   String print();
 };
 
+// Sent from the group leader as raw bytes, so both ends must have the same
+// layout. The police and service light flash step/beat fields changed it, a
+// follower drops a state of another size rather than misread it.
 struct __attribute__((packed)) EffectSyncState
 {
   RGBSyncData rgbSyncData;
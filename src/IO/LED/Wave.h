@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+// Fixed point periodic functions for effects.
+//
+// A phase is a uint32_t where the full range is one cycle, so phase
+// accumulators wrap for free and a ramp along a strip is a start phase plus a
+// per-pixel step. The sine comes from a 256 entry table with linear
+// interpolation (error below 2e-4).
+class Wave
+{
+public:
+  // Cycles (any range, fractional) to a phase
+  static uint32_t phase(float cycles) { return (uint32_t)(int64_t)(cycles * 4294967296.0); }
+
+  // sin(2 * PI * phase) in Q15, -32767 to 32767
+  static inline int16_t sin(uint32_t phase)
+  {
+    uint8_t index = phase >> 24;
+    int32_t fraction = (phase >> 8) & 0xFFFF;
+    int32_t a = SINE_TABLE[index];
+    int32_t b = SINE_TABLE[index + 1];
+    return a + (((b - a) * fraction) >> 16);
+  }
+
+  // (1 + sin(2 * PI * phase)) / 2 in Q16, 1 to 65535
+  static inline uint16_t unit(uint32_t phase) { return 32768 + sin(phase); }
+
+private:
+  static const int16_t SINE_TABLE[257];
+};
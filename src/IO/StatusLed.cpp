@@ -41,8 +41,8 @@ void StatusLeds::show()
 {
   if (_initialized)
   {
-    timeProfiler.start("StatusLed_show", TimeUnit::MICROSECONDS);
-    timeProfiler.increment("StatusLed_show");
+    timeProfiler.start(PROFILER_ID("StatusLed_show"), TimeUnit::MICROSECONDS);
+    timeProfiler.increment(PROFILER_ID("StatusLed_show"));
 
     if (xSemaphoreTake(fastledMutex, portMAX_DELAY) == pdPASS)
     {
@@ -50,7 +50,7 @@ void StatusLeds::show()
       xSemaphoreGive(fastledMutex);
     }
 
-    timeProfiler.stop("StatusLed_show");
+    timeProfiler.stop(PROFILER_ID("StatusLed_show"));
   }
   else
   {
@@ -193,8 +193,8 @@ void StatusLeds::_showTask(void *pvParameters)
   // Use a local copy of taskRunning status to reduce race conditions
   while (statusLeds->_taskRunning)
   {
-    timeProfiler.start("StatusLed_showTask_loop", TimeUnit::MICROSECONDS);
-    timeProfiler.increment("StatusLed_showTask_loop");
+    timeProfiler.start(PROFILER_ID("StatusLed_showTask_loop"), TimeUnit::MICROSECONDS);
+    timeProfiler.increment(PROFILER_ID("StatusLed_showTask_loop"));
 
     TickType_t startTime = xTaskGetTickCount();
 
@@ -203,7 +203,7 @@ void StatusLeds::_showTask(void *pvParameters)
     TickType_t endTime = xTaskGetTickCount();
     TickType_t elapsedTime = endTime - startTime;
 
-    timeProfiler.stop("StatusLed_showTask_loop");
+    timeProfiler.stop(PROFILER_ID("StatusLed_showTask_loop"));
 
     if (!statusLeds->_taskRunning)
       break;
@@ -1,7 +1,6 @@
 #include "TimeProfiler.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include <set>
 
 // Static task handle
 static TaskHandle_t callCounterResetTaskHandle = NULL;
@@ -20,14 +19,19 @@ static void callCounterResetTask(void *parameter)
 
 TimeProfiler::TimeProfiler()
 {
-  // Constructor - maps are automatically initialized
-  // Initialize mutexes
-  timingMutex = xSemaphoreCreateMutex();
-  callCountMutex = xSemaphoreCreateMutex();
+  slotCount.store(0);
+  overflowReported = false;
+  cyclesPerUs = 1;
+  activeWindow.store(0);
+  windowSeconds = 0;
+  registryMutex = xSemaphoreCreateMutex();
 }
 
 void TimeProfiler::begin()
 {
+  // The cycle counter runs at the CPU clock
+  cyclesPerUs = std::max<uint32_t>(1, getCpuFrequencyMhz());
+
   // Create FreeRTOS task to reset call counters every second
   xTaskCreatePinnedToCore(
       callCounterResetTask,        // Task function
@@ -40,327 +44,409 @@ void TimeProfiler::begin()
   );
 }
 
-void TimeProfiler::start(const String &key, TimeUnit unit)
+ProfilerId TimeProfiler::registerKey(const String &key)
 {
-  if (xSemaphoreTake(timingMutex, portMAX_DELAY) == pdTRUE)
+  ProfilerId id = PROFILER_INVALID_ID;
+  if (xSemaphoreTake(registryMutex, portMAX_DELAY) == pdTRUE)
   {
-    if (unit == TimeUnit::MICROSECONDS)
+    auto it = ids.find(key);
+    if (it != ids.end())
     {
-      startTimes[key] = micros();
+      id = it->second;
     }
-    else
+    else if (slotCount.load() < MAX_KEYS)
+    {
+      id = slotCount.load();
+      slots[id].key = key;
+      slots[id].windows = new Histogram[HISTOGRAMS];
+      resetSlot(slots[id]);
+      ids[key] = id;
+
+      // Publish the slot only once it is filled in
+      slotCount.store(id + 1, std::memory_order_release);
+    }
+    else if (!overflowReported)
     {
-      startTimes[key] = millis();
+      overflowReported = true;
+      Serial.println("TimeProfiler: too many keys, not tracking " + key);
     }
-    startUnits[key] = unit;
-    xSemaphoreGive(timingMutex);
+    xSemaphoreGive(registryMutex);
   }
+  return id;
 }
 
-void TimeProfiler::stop(const String &key)
+ProfilerId TimeProfiler::findKey(const String &key)
 {
-  if (xSemaphoreTake(timingMutex, portMAX_DELAY) == pdTRUE)
+  ProfilerId id = PROFILER_INVALID_ID;
+  if (xSemaphoreTake(registryMutex, portMAX_DELAY) == pdTRUE)
   {
-    if (startTimes.find(key) != startTimes.end() && startUnits.find(key) != startUnits.end())
-    {
-      TimingData data;
-      data.unit = startUnits[key];
+    auto it = ids.find(key);
+    if (it != ids.end())
+      id = it->second;
+    xSemaphoreGive(registryMutex);
+  }
+  return id;
+}
 
-      if (data.unit == TimeUnit::MICROSECONDS)
-      {
-        data.time = micros() - startTimes[key];
-      }
-      else
-      {
-        data.time = millis() - startTimes[key];
-      }
+uint32_t TimeProfiler::getTotalCalls(const Slot &slot) const
+{
+  uint32_t total = 0;
+  for (uint8_t core = 0; core < portNUM_PROCESSORS; core++)
+    total += slot.calls[core];
+  return total;
+}
 
-      elapsedTimes[key] = data;
-      startTimes.erase(key); // Remove from start times to free memory
-      startUnits.erase(key); // Remove from start units to free memory
-    }
-    xSemaphoreGive(timingMutex);
+void TimeProfiler::resetSlot(Slot &slot)
+{
+  slot.unit = TimeUnit::MICROSECONDS;
+  slot.hasTime = false;
+  slot.elapsed = 0;
+  for (uint8_t core = 0; core < portNUM_PROCESSORS; core++)
+  {
+    slot.startTime[core] = 0;
+    slot.calls[core] = 0;
   }
+  slot.callsAtReset = 0;
+  slot.callsPerSecond = 0;
+  for (uint8_t h = 0; h < HISTOGRAMS; h++)
+    resetHistogram(slot.windows[h]);
+}
+
+void TimeProfiler::resetHistogram(Histogram &histogram)
+{
+  memset(histogram.counts, 0, sizeof(histogram.counts));
+  histogram.samples = 0;
+  histogram.min = 0;
+  histogram.max = 0;
+  histogram.sum = 0;
+}
+
+uint32_t TimeProfiler::bucketUpperBound(uint8_t bucket)
+{
+  if (bucket < HISTOGRAM_LINEAR)
+    return bucket;
+  if (bucket >= HISTOGRAM_BUCKETS - 1)
+    return UINT32_MAX;
+
+  uint8_t octave = 3 + (bucket - HISTOGRAM_LINEAR) / 4;
+  uint8_t sub = (bucket - HISTOGRAM_LINEAR) % 4;
+  return ((4u + sub + 1) << (octave - 2)) - 1;
+}
+
+void TimeProfiler::start(const String &key, TimeUnit unit)
+{
+#ifndef TIME_PROFILER_DISABLED
+  start(registerKey(key), unit);
+#endif
+}
+
+void TimeProfiler::stop(const String &key)
+{
+#ifndef TIME_PROFILER_DISABLED
+  stop(findKey(key));
+#endif
 }
 
 uint32_t TimeProfiler::getTime(const String &key)
 {
-  uint32_t result = 0;
-  if (xSemaphoreTake(timingMutex, portMAX_DELAY) == pdTRUE)
-  {
-    auto it = elapsedTimes.find(key);
-    if (it != elapsedTimes.end())
-    {
-      result = it->second.time;
-    }
-    xSemaphoreGive(timingMutex);
-  }
-  return result;
+  ProfilerId id = findKey(key);
+  if (id == PROFILER_INVALID_ID)
+    return 0;
+  return slots[id].elapsed;
 }
 
 TimeUnit TimeProfiler::getTimeUnit(const String &key)
 {
-  TimeUnit result = TimeUnit::MICROSECONDS; // Default fallback
-  if (xSemaphoreTake(timingMutex, portMAX_DELAY) == pdTRUE)
-  {
-    auto it = elapsedTimes.find(key);
-    if (it != elapsedTimes.end())
-    {
-      result = it->second.unit;
-    }
-    xSemaphoreGive(timingMutex);
-  }
-  return result;
+  ProfilerId id = findKey(key);
+  if (id == PROFILER_INVALID_ID)
+    return TimeUnit::MICROSECONDS; // Default fallback
+  return slots[id].unit;
 }
 
 uint32_t TimeProfiler::getTimeUs(const String &key)
 {
-  uint32_t result = 0;
-  if (xSemaphoreTake(timingMutex, portMAX_DELAY) == pdTRUE)
-  {
-    auto it = elapsedTimes.find(key);
-    if (it != elapsedTimes.end())
-    {
-      if (it->second.unit == TimeUnit::MICROSECONDS)
-      {
-        result = it->second.time;
-      }
-      else
-      {
-        result = it->second.time * 1000; // Convert ms to us
-      }
-    }
-    xSemaphoreGive(timingMutex);
-  }
-  return result;
+  ProfilerId id = findKey(key);
+  if (id == PROFILER_INVALID_ID)
+    return 0;
+
+  const Slot &slot = slots[id];
+  if (slot.unit == TimeUnit::MICROSECONDS)
+    return slot.elapsed;
+  return slot.elapsed * 1000; // Convert ms to us
 }
 
 float TimeProfiler::getTimeMs(const String &key)
 {
-  float result = 0.0f;
-  if (xSemaphoreTake(timingMutex, portMAX_DELAY) == pdTRUE)
-  {
-    auto it = elapsedTimes.find(key);
-    if (it != elapsedTimes.end())
-    {
-      if (it->second.unit == TimeUnit::MILLISECONDS)
-      {
-        result = (float)it->second.time;
-      }
-      else
-      {
-        result = it->second.time / 1000.0f; // Convert us to ms
-      }
-    }
-    xSemaphoreGive(timingMutex);
-  }
-  return result;
+  ProfilerId id = findKey(key);
+  if (id == PROFILER_INVALID_ID)
+    return 0.0f;
+
+  const Slot &slot = slots[id];
+  if (slot.unit == TimeUnit::MILLISECONDS)
+    return (float)slot.elapsed;
+  return slot.elapsed / 1000.0f; // Convert us to ms
 }
 
 // === CALL COUNTING SYSTEM METHODS ===
 void TimeProfiler::increment(const String &key)
 {
-  if (xSemaphoreTake(callCountMutex, portMAX_DELAY) == pdTRUE)
-  {
-    callCounts[key]++;
-    xSemaphoreGive(callCountMutex);
-  }
+#ifndef TIME_PROFILER_DISABLED
+  increment(registerKey(key));
+#endif
 }
 
 uint32_t TimeProfiler::getCallsPerSecond(const String &key)
 {
-  uint32_t result = 0;
-  if (xSemaphoreTake(callCountMutex, portMAX_DELAY) == pdTRUE)
-  {
-    auto it = callsPerSecond.find(key);
-    if (it != callsPerSecond.end())
-    {
-      result = it->second;
-    }
-    xSemaphoreGive(callCountMutex);
-  }
-  return result;
+  ProfilerId id = findKey(key);
+  if (id == PROFILER_INVALID_ID)
+    return 0;
+  return slots[id].callsPerSecond;
 }
 
 uint32_t TimeProfiler::getCurrentCallCount(const String &key)
 {
-  uint32_t result = 0;
-  if (xSemaphoreTake(callCountMutex, portMAX_DELAY) == pdTRUE)
-  {
-    auto it = callCounts.find(key);
-    if (it != callCounts.end())
-    {
-      result = it->second;
-    }
-    xSemaphoreGive(callCountMutex);
-  }
-  return result;
+  ProfilerId id = findKey(key);
+  if (id == PROFILER_INVALID_ID)
+    return 0;
+  return getTotalCalls(slots[id]) - slots[id].callsAtReset;
 }
 
 void TimeProfiler::resetCallCounters()
 {
-  if (xSemaphoreTake(callCountMutex, portMAX_DELAY) == pdTRUE)
+  // Counters only count up, so a second's worth is the difference to the
+  // last reset. Nothing is written that the hot path also writes.
+  uint16_t count = slotCount.load(std::memory_order_acquire);
+  for (uint16_t id = 0; id < count; id++)
   {
-    // Copy current call counts to calls per second
-    for (const auto &pair : callCounts)
-    {
-      callsPerSecond[pair.first] = pair.second;
-    }
+    Slot &slot = slots[id];
+    uint32_t total = getTotalCalls(slot);
+    slot.callsPerSecond = total - slot.callsAtReset;
+    slot.callsAtReset = total;
+  }
 
-    // Reset call counters for next second
-    callCounts.clear();
-    xSemaphoreGive(callCountMutex);
+  if (++windowSeconds >= HISTOGRAM_WINDOW_SECONDS)
+  {
+    windowSeconds = 0;
+    rotateWindows();
   }
 }
 
-// === SHARED UTILITIES ===
-bool TimeProfiler::hasKey(const String &key)
+void TimeProfiler::rotateWindows()
 {
-  bool result = false;
+  // Empty the oldest window before it becomes active. A stop() that read the
+  // old index just before the switch still lands in the previous window.
+  uint8_t next = activeWindow.load() ^ 1;
+  uint16_t count = slotCount.load(std::memory_order_acquire);
+  for (uint16_t id = 0; id < count; id++)
+    for (uint8_t core = 0; core < portNUM_PROCESSORS; core++)
+      resetHistogram(slots[id].windows[next * portNUM_PROCESSORS + core]);
+  activeWindow.store(next, std::memory_order_release);
+}
 
-  // Check timing data
-  if (xSemaphoreTake(timingMutex, portMAX_DELAY) == pdTRUE)
+// === LATENCY HISTOGRAMS ===
+bool TimeProfiler::getSnapshot(ProfilerId id, ProfilerSnapshot &snapshot)
+{
+  memset(&snapshot, 0, sizeof(snapshot));
+  if (id >= slotCount.load(std::memory_order_acquire))
+    return false;
+
+  // Merge both windows of every core into a local copy so the percentiles
+  // are consistent
+  const Slot &slot = slots[id];
+  Histogram merged;
+  resetHistogram(merged);
+  for (uint8_t h = 0; h < HISTOGRAMS; h++)
   {
-    result = elapsedTimes.find(key) != elapsedTimes.end();
-    xSemaphoreGive(timingMutex);
+    const Histogram &window = slot.windows[h];
+    if (window.samples == 0)
+      continue;
+
+    for (uint8_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+      merged.counts[b] = std::min<uint32_t>(0xFFFF, merged.counts[b] + window.counts[b]);
+    if (merged.samples == 0 || window.min < merged.min)
+      merged.min = window.min;
+    merged.max = std::max(merged.max, window.max);
+    merged.sum += window.sum;
+    merged.samples += window.samples;
   }
 
-  // If not found in timing data, check call count data
-  if (!result && xSemaphoreTake(callCountMutex, portMAX_DELAY) == pdTRUE)
+  if (merged.samples == 0)
+    return false;
+
+  snapshot.unit = slot.unit;
+  snapshot.samples = merged.samples;
+  snapshot.min = merged.min;
+  snapshot.max = merged.max;
+  snapshot.mean = merged.sum / merged.samples;
+
+  // Bucket counts saturate, so rank against their own total
+  uint32_t bucketTotal = 0;
+  for (uint8_t b = 0; b < HISTOGRAM_BUCKETS; b++)
+    bucketTotal += merged.counts[b];
+
+  const uint8_t percentiles[] = {50, 95, 99};
+  uint32_t *results[] = {&snapshot.p50, &snapshot.p95, &snapshot.p99};
+  for (uint8_t p = 0; p < 3; p++)
   {
-    result = callsPerSecond.find(key) != callsPerSecond.end() ||
-             callCounts.find(key) != callCounts.end();
-    xSemaphoreGive(callCountMutex);
+    uint32_t rank = (bucketTotal * percentiles[p] + 99) / 100;
+    uint32_t seen = 0;
+    uint8_t b = 0;
+    for (; b < HISTOGRAM_BUCKETS - 1; b++)
+    {
+      seen += merged.counts[b];
+      if (seen >= rank)
+        break;
+    }
+    *results[p] = std::max(merged.min, std::min(merged.max, bucketUpperBound(b)));
   }
 
-  return result;
+  return true;
 }
 
-void TimeProfiler::clear()
+bool TimeProfiler::getSnapshot(const String &key, ProfilerSnapshot &snapshot)
 {
-  // Clear timing data
-  if (xSemaphoreTake(timingMutex, portMAX_DELAY) == pdTRUE)
-  {
-    startTimes.clear();
-    startUnits.clear();
-    elapsedTimes.clear();
-    xSemaphoreGive(timingMutex);
-  }
+  return getSnapshot(findKey(key), snapshot);
+}
 
-  // Clear call count data
-  if (xSemaphoreTake(callCountMutex, portMAX_DELAY) == pdTRUE)
-  {
-    callCounts.clear();
-    callsPerSecond.clear();
-    xSemaphoreGive(callCountMutex);
-  }
+void TimeProfiler::resetHistogram(ProfilerId id)
+{
+  if (id >= slotCount.load(std::memory_order_acquire))
+    return;
+  for (uint8_t h = 0; h < HISTOGRAMS; h++)
+    resetHistogram(slots[id].windows[h]);
 }
 
-void TimeProfiler::remove(const String &key)
+void TimeProfiler::resetHistogram(const String &key)
+{
+  resetHistogram(findKey(key));
+}
+
+void TimeProfiler::resetHistograms()
+{
+  uint16_t count = slotCount.load(std::memory_order_acquire);
+  for (uint16_t id = 0; id < count; id++)
+    resetHistogram(id);
+}
+
+void TimeProfiler::printHistograms()
 {
-  // Remove from timing data
-  if (xSemaphoreTake(timingMutex, portMAX_DELAY) == pdTRUE)
+  Serial.println("=== TimeProfiler Latency (last " + String(HISTOGRAM_WINDOW_SECONDS) + "-" +
+                 String(HISTOGRAM_WINDOW_SECONDS * 2) + "s) ===");
+  Serial.println("key: samples min / mean / p50 / p95 / p99 / max");
+
+  std::map<String, ProfilerId> sorted;
+  if (xSemaphoreTake(registryMutex, portMAX_DELAY) == pdTRUE)
   {
-    startTimes.erase(key);
-    startUnits.erase(key);
-    elapsedTimes.erase(key);
-    xSemaphoreGive(timingMutex);
+    sorted = ids;
+    xSemaphoreGive(registryMutex);
   }
 
-  // Remove from call count data
-  if (xSemaphoreTake(callCountMutex, portMAX_DELAY) == pdTRUE)
+  for (const auto &pair : sorted)
   {
-    callCounts.erase(key);
-    callsPerSecond.erase(key);
-    xSemaphoreGive(callCountMutex);
+    ProfilerSnapshot snapshot;
+    if (!getSnapshot(pair.second, snapshot))
+      continue;
+
+    Serial.print(pair.first);
+    Serial.print(": ");
+    Serial.print(snapshot.samples);
+    Serial.print(" ");
+    Serial.print(snapshot.min);
+    Serial.print(" / ");
+    Serial.print(snapshot.mean);
+    Serial.print(" / ");
+    Serial.print(snapshot.p50);
+    Serial.print(" / ");
+    Serial.print(snapshot.p95);
+    Serial.print(" / ");
+    Serial.print(snapshot.p99);
+    Serial.print(" / ");
+    Serial.print(snapshot.max);
+    Serial.println(snapshot.unit == TimeUnit::MICROSECONDS ? " μs" : " ms");
   }
+  Serial.println("=============================");
+}
+
+// === SHARED UTILITIES ===
+bool TimeProfiler::hasKey(const String &key)
+{
+  ProfilerId id = findKey(key);
+  if (id == PROFILER_INVALID_ID)
+    return false;
+
+  const Slot &slot = slots[id];
+  return slot.hasTime || slot.callsPerSecond > 0 || getTotalCalls(slot) > 0;
+}
+
+void TimeProfiler::clear()
+{
+  // Ids stay valid, only the data is dropped
+  uint16_t count = slotCount.load(std::memory_order_acquire);
+  for (uint16_t id = 0; id < count; id++)
+    resetSlot(slots[id]);
+}
+
+void TimeProfiler::remove(const String &key)
+{
+  ProfilerId id = findKey(key);
+  if (id != PROFILER_INVALID_ID)
+    resetSlot(slots[id]);
 }
 
 void TimeProfiler::printAll()
 {
   Serial.println("=== TimeProfiler Results ===");
 
-  // Collect all unique keys from both systems
-  std::set<String> allKeys;
-
-  // Collect keys from timing system
-  if (xSemaphoreTake(timingMutex, portMAX_DELAY) == pdTRUE)
+  // Sorted by key, like the old map based storage
+  std::map<String, ProfilerId> sorted;
+  if (xSemaphoreTake(registryMutex, portMAX_DELAY) == pdTRUE)
   {
-    for (const auto &pair : elapsedTimes)
-    {
-      allKeys.insert(pair.first);
-    }
-    xSemaphoreGive(timingMutex);
+    sorted = ids;
+    xSemaphoreGive(registryMutex);
   }
 
-  // Collect keys from call count system
-  if (xSemaphoreTake(callCountMutex, portMAX_DELAY) == pdTRUE)
+  for (const auto &pair : sorted)
   {
-    for (const auto &pair : callsPerSecond)
-    {
-      allKeys.insert(pair.first);
-    }
-    for (const auto &pair : callCounts)
-    {
-      allKeys.insert(pair.first);
-    }
-    xSemaphoreGive(callCountMutex);
-  }
+    const Slot &slot = slots[pair.second];
+    uint32_t totalCalls = getTotalCalls(slot);
+    if (!slot.hasTime && slot.callsPerSecond == 0 && totalCalls == 0)
+      continue;
 
-  for (const String &key : allKeys)
-  {
-    Serial.print(key);
+    Serial.print(pair.first);
     Serial.print(": ");
 
     // Print timing data if available
-    bool hasTimingData = false;
-    if (xSemaphoreTake(timingMutex, portMAX_DELAY) == pdTRUE)
+    if (slot.hasTime)
     {
-      auto timingIt = elapsedTimes.find(key);
-      if (timingIt != elapsedTimes.end())
+      Serial.print(slot.elapsed);
+      if (slot.unit == TimeUnit::MICROSECONDS)
+      {
+        Serial.print(" μs (");
+        Serial.print(slot.elapsed / 1000.0f);
+        Serial.print(" ms)");
+      }
+      else
       {
-        hasTimingData = true;
-        Serial.print(timingIt->second.time);
-        if (timingIt->second.unit == TimeUnit::MICROSECONDS)
-        {
-          Serial.print(" μs (");
-          Serial.print(timingIt->second.time / 1000.0f);
-          Serial.print(" ms)");
-        }
-        else
-        {
-          Serial.print(" ms (");
-          Serial.print(timingIt->second.time * 1000);
-          Serial.print(" μs)");
-        }
+        Serial.print(" ms (");
+        Serial.print(slot.elapsed * 1000);
+        Serial.print(" μs)");
       }
-      xSemaphoreGive(timingMutex);
     }
-
-    if (!hasTimingData)
+    else
     {
       Serial.print("no timing data");
     }
 
     // Print call data if available
-    if (xSemaphoreTake(callCountMutex, portMAX_DELAY) == pdTRUE)
+    if (totalCalls > 0)
     {
-      auto cpsIt = callsPerSecond.find(key);
-      if (cpsIt != callsPerSecond.end())
-      {
-        Serial.print(" - ");
-        Serial.print(cpsIt->second);
-        Serial.print(" calls/sec");
-      }
+      Serial.print(" - ");
+      Serial.print(slot.callsPerSecond);
+      Serial.print(" calls/sec");
 
-      auto currentIt = callCounts.find(key);
-      if (currentIt != callCounts.end())
-      {
-        Serial.print(" (current: ");
-        Serial.print(currentIt->second);
-        Serial.print(")");
-      }
-      xSemaphoreGive(callCountMutex);
+      Serial.print(" (current: ");
+      Serial.print(totalCalls - slot.callsAtReset);
+      Serial.print(")");
     }
 
     Serial.println();
@@ -369,4 +455,4 @@ void TimeProfiler::printAll()
 }
 
 // Global instance
-TimeProfiler timeProfiler;
\ No newline at end of file
+TimeProfiler timeProfiler;
@@ -2,35 +2,126 @@
 
 #include <Arduino.h>
 #include <map>
+#include <atomic>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 
+// Build with -DTIME_PROFILER_DISABLED to compile start/stop/increment to nothing.
+// The getters keep working and report zeros.
+
 enum class TimeUnit
 {
   MICROSECONDS,
   MILLISECONDS
 };
 
-struct TimingData
+// Latency summary over the rolling window, in the key's recorded unit.
+// Percentiles are bucket upper bounds (within ~19%), clamped to max.
+struct ProfilerSnapshot
 {
-  uint32_t time;
   TimeUnit unit;
+  uint32_t samples;
+  uint32_t min;
+  uint32_t max;
+  uint32_t mean;
+  uint32_t p50;
+  uint32_t p95;
+  uint32_t p99;
 };
 
+// Profiler keys are registered once and used by id afterwards
+typedef uint16_t ProfilerId;
+static const ProfilerId PROFILER_INVALID_ID = 0xFFFF;
+
+// Registers key the first time this line runs and returns the id from then on
+#ifndef TIME_PROFILER_DISABLED
+#define PROFILER_ID(key) ([]() -> ProfilerId { static const ProfilerId id = timeProfiler.registerKey(key); return id; }())
+#else
+#define PROFILER_ID(key) PROFILER_INVALID_ID
+#endif
+
 class TimeProfiler
 {
 private:
-  std::map<String, uint32_t> startTimes;
-  std::map<String, TimeUnit> startUnits;
-  std::map<String, TimingData> elapsedTimes;
-
-  // Separate call counting system
-  std::map<String, uint32_t> callCounts;
-  std::map<String, uint32_t> callsPerSecond;
-
-  // Mutexes for thread safety
-  SemaphoreHandle_t timingMutex;
-  SemaphoreHandle_t callCountMutex;
+  static const uint16_t MAX_KEYS = 96;
+
+  // Log-bucketed latency histogram: values below 8 get their own bucket,
+  // above that every power of two is split into 4 buckets up to 2^22.
+  static const uint8_t HISTOGRAM_LINEAR = 8;
+  static const uint8_t HISTOGRAM_MAX_OCTAVE = 22;
+  static const uint8_t HISTOGRAM_BUCKETS = HISTOGRAM_LINEAR + (HISTOGRAM_MAX_OCTAVE - 3) * 4 + 1; // + overflow
+  static const uint8_t HISTOGRAM_WINDOW_SECONDS = 5;
+  static const uint8_t HISTOGRAMS = 2 * portNUM_PROCESSORS; // per slot
+
+  struct Histogram
+  {
+    uint16_t counts[HISTOGRAM_BUCKETS]; // saturating
+    uint32_t samples;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+  };
+
+  // Each core only writes its own start time, call count and histograms, so
+  // the hot path needs no lock. Readers may see a value one measurement old.
+  struct Slot
+  {
+    String key;
+    TimeUnit unit;
+    bool hasTime;
+    uint32_t startTime[portNUM_PROCESSORS]; // cycles, or ms for MILLISECONDS
+    uint32_t elapsed;                       // last measurement in unit
+    uint32_t calls[portNUM_PROCESSORS];     // only ever counts up
+    uint32_t callsAtReset;
+    uint32_t callsPerSecond;
+    Histogram *windows; // [2][portNUM_PROCESSORS], allocated on registration
+  };
+
+  Slot slots[MAX_KEYS];
+  std::atomic<uint16_t> slotCount; // slots below this are fully registered
+  uint32_t cyclesPerUs;
+
+  // Samples go into windows[activeWindow]. The other one holds the previous
+  // window until the reset task rotates them.
+  std::atomic<uint8_t> activeWindow;
+  uint8_t windowSeconds;
+
+  // Name -> id, only used when registering and by the String overloads
+  std::map<String, ProfilerId> ids;
+  SemaphoreHandle_t registryMutex;
+  bool overflowReported;
+
+  ProfilerId findKey(const String &key);
+  uint32_t getTotalCalls(const Slot &slot) const;
+  void resetSlot(Slot &slot);
+  static void resetHistogram(Histogram &histogram);
+  static uint32_t bucketUpperBound(uint8_t bucket);
+  void rotateWindows();
+
+  static inline uint8_t bucketFor(uint32_t value)
+  {
+    if (value < HISTOGRAM_LINEAR)
+      return value;
+    uint8_t octave = 31 - __builtin_clz(value);
+    if (octave >= HISTOGRAM_MAX_OCTAVE)
+      return HISTOGRAM_BUCKETS - 1;
+    return HISTOGRAM_LINEAR + (octave - 3) * 4 + ((value >> (octave - 2)) & 3);
+  }
+
+  inline void record(Slot &slot, uint32_t value)
+  {
+    uint8_t window = activeWindow.load(std::memory_order_relaxed);
+    Histogram &histogram = slot.windows[window * portNUM_PROCESSORS + xPortGetCoreID()];
+    uint16_t &count = histogram.counts[bucketFor(value)];
+    if (count != 0xFFFF)
+      count++;
+    if (histogram.samples == 0 || value < histogram.min)
+      histogram.min = value;
+    if (value > histogram.max)
+      histogram.max = value;
+    histogram.sum += value;
+    histogram.samples++;
+  }
 
 public:
   TimeProfiler();
@@ -38,11 +129,43 @@ public:
   // Initialize the FreeRTOS task for call counter resets
   void begin();
 
+  // Get the id for a key, registering it on first use. Takes a lock, so keep
+  // the id instead of calling this every frame.
+  ProfilerId registerKey(const String &key);
+
   // === TIMING SYSTEM ===
   // Start timing for a given key (defaults to microseconds)
-  void start(const String &key, TimeUnit unit = TimeUnit::MICROSECONDS);
+  inline void start(ProfilerId id, TimeUnit unit = TimeUnit::MICROSECONDS)
+  {
+#ifndef TIME_PROFILER_DISABLED
+    if (id >= slotCount.load(std::memory_order_acquire))
+      return;
+
+    Slot &slot = slots[id];
+    slot.unit = unit;
+    slot.startTime[xPortGetCoreID()] = (unit == TimeUnit::MICROSECONDS) ? ESP.getCycleCount() : millis();
+#endif
+  }
 
   // Stop timing for a given key and store the elapsed time in the original unit
+  inline void stop(ProfilerId id)
+  {
+#ifndef TIME_PROFILER_DISABLED
+    if (id >= slotCount.load(std::memory_order_acquire))
+      return;
+
+    Slot &slot = slots[id];
+    uint32_t startTime = slot.startTime[xPortGetCoreID()];
+    if (slot.unit == TimeUnit::MICROSECONDS)
+      slot.elapsed = (ESP.getCycleCount() - startTime) / cyclesPerUs;
+    else
+      slot.elapsed = millis() - startTime;
+    slot.hasTime = true;
+    record(slot, slot.elapsed);
+#endif
+  }
+
+  void start(const String &key, TimeUnit unit = TimeUnit::MICROSECONDS);
   void stop(const String &key);
 
   // Get the elapsed time for a key in its original recorded unit
@@ -57,8 +180,31 @@ public:
   // Get time converted to milliseconds (regardless of original unit)
   float getTimeMs(const String &key);
 
+  // === LATENCY HISTOGRAMS ===
+  // Every stop() is recorded. Snapshots cover the current and the previous
+  // window, so between HISTOGRAM_WINDOW_SECONDS and twice that.
+  // Returns false if the key has no samples in that time.
+  bool getSnapshot(ProfilerId id, ProfilerSnapshot &snapshot);
+  bool getSnapshot(const String &key, ProfilerSnapshot &snapshot);
+
+  // Drop the recorded samples, keeping the last time and call counts
+  void resetHistogram(ProfilerId id);
+  void resetHistogram(const String &key);
+  void resetHistograms();
+
+  // Print min/mean/percentiles/max for every key with samples
+  void printHistograms();
+
   // === CALL COUNTING SYSTEM (independent of timing) ===
   // Increment the call counter for a given key
+  inline void increment(ProfilerId id)
+  {
+#ifndef TIME_PROFILER_DISABLED
+    if (id < slotCount.load(std::memory_order_acquire))
+      slots[id].calls[xPortGetCoreID()]++;
+#endif
+  }
+
   void increment(const String &key);
 
   // Get the number of calls per second for a key
@@ -80,7 +226,8 @@ public:
   // Print all timing and call statistics
   void printAll();
 
-  // Internal method called by FreeRTOS task to reset call counters
+  // Internal method called by FreeRTOS task to reset call counters and
+  // rotate the histogram windows
   void resetCallCounters();
 };
 
@@ -0,0 +1,127 @@
+#include "TraceRecorder.h"
+#include <new>
+
+TraceRecorder::TraceRecorder()
+{
+  events = nullptr;
+  writeIndex.store(0);
+  recording.store(false);
+  taskCount.store(0);
+}
+
+void TraceRecorder::start()
+{
+  recording.store(false);
+
+  if (!events)
+  {
+    events = new (std::nothrow) Event[MAX_EVENTS];
+    if (!events)
+    {
+      Serial.println("TraceRecorder: failed to allocate the event buffer");
+      return;
+    }
+  }
+
+  for (uint8_t i = 0; i < MAX_TASKS; i++)
+    tasks[i].handle = NULL;
+  taskCount.store(0);
+  writeIndex.store(0);
+
+  // Publish the buffer before any task starts writing to it
+  recording.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::stop()
+{
+  recording.store(false);
+}
+
+uint8_t TraceRecorder::getTaskIndex()
+{
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+  uint8_t count = taskCount.load(std::memory_order_acquire);
+  for (uint8_t i = 0; i < count && i < MAX_TASKS; i++)
+  {
+    if (tasks[i].handle == self)
+      return i;
+  }
+
+  // First event from this task. Only this task can add itself, so claiming
+  // a new entry cannot race with another claim for the same handle.
+  uint8_t index = taskCount.fetch_add(1);
+  if (index >= MAX_TASKS)
+  {
+    taskCount.store(MAX_TASKS);
+    return MAX_TASKS; // shown as an unnamed thread
+  }
+
+  strncpy(tasks[index].name, pcTaskGetName(NULL), sizeof(tasks[index].name) - 1);
+  tasks[index].name[sizeof(tasks[index].name) - 1] = '\0';
+  tasks[index].handle = self;
+  return index;
+}
+
+void TraceRecorder::record(const char *name, char phase)
+{
+  uint32_t index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+  Event &event = events[index & (MAX_EVENTS - 1)];
+  event.timestamp = micros();
+  event.name = name;
+  event.phase = phase;
+  event.core = xPortGetCoreID();
+  event.task = getTaskIndex();
+}
+
+uint32_t TraceRecorder::getEventCount() const
+{
+  return std::min<uint32_t>(writeIndex.load(), MAX_EVENTS);
+}
+
+void TraceRecorder::dump()
+{
+  bool wasRecording = recording.exchange(false);
+  if (wasRecording)
+    vTaskDelay(1); // let events that were being written land
+
+  if (!events)
+  {
+    Serial.println("TraceRecorder: nothing recorded");
+    return;
+  }
+
+  uint32_t total = writeIndex.load();
+  uint32_t first = total > MAX_EVENTS ? total - MAX_EVENTS : 0;
+  uint32_t startTime = events[first & (MAX_EVENTS - 1)].timestamp;
+
+  Serial.println("{\"traceEvents\":[");
+  Serial.print("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"ESP32\"}}");
+
+  uint8_t taskTotal = taskCount.load();
+  if (taskTotal > MAX_TASKS)
+    taskTotal = MAX_TASKS;
+  for (uint8_t i = 0; i < taskTotal; i++)
+  {
+    Serial.printf(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                  (unsigned int)i, tasks[i].name);
+  }
+
+  for (uint32_t i = first; i < total; i++)
+  {
+    const Event &event = events[i & (MAX_EVENTS - 1)];
+
+    // Timestamps are relative to the oldest event, which also hides micros() wrapping
+    Serial.printf(",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lu,\"pid\":0,\"tid\":%u,\"args\":{\"core\":%u}}",
+                  event.name, event.phase, (unsigned long)(event.timestamp - startTime),
+                  (unsigned int)event.task, (unsigned int)event.core);
+  }
+
+  Serial.println("\n],\"displayTimeUnit\":\"ms\"}");
+
+  if (wasRecording)
+    recording.store(true, std::memory_order_release);
+}
+
+// Global instance
+TraceRecorder traceRecorder;
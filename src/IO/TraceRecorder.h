@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Records begin/end events with core and task into a fixed RAM ring buffer
+// and dumps them as Chrome trace_event JSON (chrome://tracing, Perfetto).
+//
+// Recording is off until start() is called, so an idle recorder costs one
+// load per event and no RAM. Event names are stored as pointers and must
+// outlive the recording: string literals or Strings owned by long-lived
+// objects.
+class TraceRecorder
+{
+private:
+  static const uint16_t MAX_EVENTS = 2048; // power of two, 12 bytes each
+  static const uint8_t MAX_TASKS = 12;
+
+  struct Event
+  {
+    uint32_t timestamp; // micros()
+    const char *name;
+    char phase; // 'B' or 'E'
+    uint8_t core;
+    uint8_t task; // index into tasks
+  };
+
+  struct Task
+  {
+    TaskHandle_t handle;
+    char name[16];
+  };
+
+  Event *events;
+  std::atomic<uint32_t> writeIndex; // total events recorded since start()
+  std::atomic<bool> recording;
+
+  Task tasks[MAX_TASKS];
+  std::atomic<uint8_t> taskCount;
+
+  uint8_t getTaskIndex();
+  void record(const char *name, char phase);
+
+public:
+  TraceRecorder();
+
+  // Clear the buffer and start recording. Allocates the buffer on first use.
+  void start();
+  void stop();
+  bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+
+  inline void beginEvent(const char *name)
+  {
+    if (recording.load(std::memory_order_acquire))
+      record(name, 'B');
+  }
+
+  inline void endEvent(const char *name)
+  {
+    if (recording.load(std::memory_order_acquire))
+      record(name, 'E');
+  }
+
+  // Number of events currently held (at most MAX_EVENTS)
+  uint32_t getEventCount() const;
+
+  // Print the buffer as Chrome trace JSON. Pauses recording while printing.
+  void dump();
+};
+
+// Global instance
+extern TraceRecorder traceRecorder;
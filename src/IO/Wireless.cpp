@@ -84,7 +84,7 @@ void Wireless::sendCallback(const uint8_t *mac_addr,
 void Wireless::recvCallback(const uint8_t *mac_addr, const uint8_t *data,
                             int len)
 {
-  timeProfiler.increment("packetPps");
+  timeProfiler.increment(PROFILER_ID("packetPps"));
   char macStr[18];
   snprintf(macStr, sizeof(macStr),
            "%02x:%02x:%02x:%02x:%02x:%02x",
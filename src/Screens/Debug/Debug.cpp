@@ -38,6 +38,11 @@ namespace DebugScreenNamespace
   static uint32_t syncManagerLoopTime = 0;
   static uint32_t handleSyncPacketTime = 0;
 
+  // Tail latency from the TimeProfiler histograms
+  static uint32_t updateEffectsP99 = 0;
+  static uint32_t drawEffectsP99 = 0;
+  static uint32_t drawEffectsMax = 0;
+
   // Calls per second variables
   static uint32_t ledFps = 0;
   static uint32_t displayFps = 0;
@@ -72,6 +77,9 @@ namespace DebugScreenNamespace
   static MenuItemNumber<uint32_t> updateSyncTimeItem = MenuItemNumber<uint32_t>("usync", &updateSyncTime);
   static MenuItemNumber<uint32_t> updateEffectsTimeItem = MenuItemNumber<uint32_t>("ueeffect", &updateEffectsTime);
   static MenuItemNumber<uint32_t> drawEffectsTimeItem = MenuItemNumber<uint32_t>("deffect", &drawEffectsTime);
+  static MenuItemNumber<uint32_t> updateEffectsP99Item = MenuItemNumber<uint32_t>("ue p99", &updateEffectsP99);
+  static MenuItemNumber<uint32_t> drawEffectsP99Item = MenuItemNumber<uint32_t>("de p99", &drawEffectsP99);
+  static MenuItemNumber<uint32_t> drawEffectsMaxItem = MenuItemNumber<uint32_t>("de max", &drawEffectsMax);
 
   // Fps items
   static MenuItem fpsItem = MenuItem("FPS");
@@ -110,6 +118,9 @@ namespace DebugScreenNamespace
     menu.addMenuItem(&updateSyncTimeItem);
     menu.addMenuItem(&updateEffectsTimeItem);
     menu.addMenuItem(&drawEffectsTimeItem);
+    menu.addMenuItem(&updateEffectsP99Item);
+    menu.addMenuItem(&drawEffectsP99Item);
+    menu.addMenuItem(&drawEffectsMaxItem);
 
     // FPS items
     menu.addMenuItem(&fpsItem);
@@ -159,6 +170,13 @@ namespace DebugScreenNamespace
     syncManagerLoopTime = timeProfiler.getTimeUs("syncManagerLoop");
     handleSyncPacketTime = timeProfiler.getTimeUs("handleSyncPacket");
 
+    ProfilerSnapshot snapshot;
+    timeProfiler.getSnapshot("updateEffects", snapshot);
+    updateEffectsP99 = snapshot.p99;
+    timeProfiler.getSnapshot("ledFps", snapshot);
+    drawEffectsP99 = snapshot.p99;
+    drawEffectsMax = snapshot.max;
+
     // Update calls per second data from TimeProfiler
     ledFps = timeProfiler.getCallsPerSecond("ledFps");
     displayFps = timeProfiler.getCallsPerSecond("displayFps");
@@ -193,7 +193,7 @@ void printLEDStripBuffers()
     {
       Serial.println("[" + String(stripNames[i]) + " Strip]");
 
-      Color *buffer = ledManager->getStripBuffer(stripTypes[i]);
+      const CRGB *buffer = ledManager->getStripBuffer(stripTypes[i]);
       uint16_t ledCount = ledManager->getStripLEDCount(stripTypes[i]);
       LEDStrip *strip = ledManager->getStrip(stripTypes[i]);
 
@@ -203,6 +203,11 @@ void printLEDStripBuffers()
         Serial.println("  Brightness: " + String(strip->getBrightness()));
         // Serial.println("  FPS: " + String(strip->getFPS()));
         Serial.println("  Flipped: " + String(strip->getFliped() ? "Yes" : "No"));
+        Serial.println("  Frames: " + String(strip->getPublishedFrames()) + " published, " +
+                       String(strip->getDroppedFrames()) + " dropped, " +
+                       String(strip->getRepeatedFrames()) + " repeated");
+        Serial.println("  Shared renders: " + String(strip->getSharedRenders()) + " of " +
+                       String(strip->getShareableRenders()));
 
         // Print first 10 LEDs (or all if less than 10)
         uint16_t printCount = min(ledCount, (uint16_t)10);
@@ -264,7 +269,7 @@ void printSpecificLEDStripBuffer(const String &stripName)
     return;
   }
 
-  Color *buffer = ledManager->getStripBuffer(stripType);
+  const CRGB *buffer = ledManager->getStripBuffer(stripType);
   uint16_t ledCount = ledManager->getStripLEDCount(stripType);
   LEDStrip *strip = ledManager->getStrip(stripType);
 
@@ -274,6 +279,11 @@ void printSpecificLEDStripBuffer(const String &stripName)
     Serial.println("Brightness: " + String(strip->getBrightness()));
     // Serial.println("FPS: " + String(strip->getFPS()));
     Serial.println("Flipped: " + String(strip->getFliped() ? "Yes" : "No"));
+    Serial.println("Frames: " + String(strip->getPublishedFrames()) + " published, " +
+                   String(strip->getDroppedFrames()) + " dropped, " +
+                   String(strip->getRepeatedFrames()) + " repeated");
+    Serial.println("Shared renders: " + String(strip->getSharedRenders()) + " of " +
+                   String(strip->getShareableRenders()));
     Serial.println();
 
     Serial.println("All LED Colors:");
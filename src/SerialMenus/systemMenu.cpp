@@ -14,6 +14,10 @@
 
 #include <WiFi.h> // If you're using WiFi.localIP, etc.
 
+#include "IO/TimeProfiler.h"
+#include "IO/TraceRecorder.h"
+#include "IO/LED/LEDArena.h"
+
 SerialMenu systemMenu = {
     F("System"),
     &mainMenu, // parent is mainMenu
@@ -29,6 +33,12 @@ void printSystemMenu(const SerialMenu &menu)
     Serial.println(F("3) Get IP"));
     Serial.println(F("4) Get MAC"));
     Serial.println(F("5) Sysinfo"));
+    Serial.println(F("6) Profiler timings"));
+    Serial.println(F("7) Profiler latency histograms"));
+    Serial.println(F("8) Reset latency histograms"));
+    Serial.println(F("9) Start/stop frame trace"));
+    Serial.println(F("10) Dump frame trace (Chrome trace JSON)"));
+    Serial.println(F("11) LED buffer memory"));
     Serial.println(F("b) Back"));
     Serial.println(F("Press Enter to re-print this menu"));
 }
@@ -76,6 +86,47 @@ bool handleSystemMenuInput(SerialMenu &menu, const String &input)
                        formatBytes(usedPsram) + String(F(" / ")) + formatBytes(ESP.getPsramSize()));
         return true;
     }
+    else if (input == F("6"))
+    {
+        timeProfiler.printAll();
+        return true;
+    }
+    else if (input == F("7"))
+    {
+        timeProfiler.printHistograms();
+        return true;
+    }
+    else if (input == F("8"))
+    {
+        timeProfiler.resetHistograms();
+        Serial.println(F("Latency histograms reset"));
+        return true;
+    }
+    else if (input == F("9"))
+    {
+        if (traceRecorder.isRecording())
+        {
+            traceRecorder.stop();
+            Serial.println(String(F("Trace stopped, ")) + traceRecorder.getEventCount() + F(" events"));
+        }
+        else
+        {
+            traceRecorder.start();
+            Serial.println(F("Trace recording"));
+        }
+        return true;
+    }
+    else if (input == F("10"))
+    {
+        // Save the output between the braces as a .json file
+        traceRecorder.dump();
+        return true;
+    }
+    else if (input == F("11"))
+    {
+        ledArena.printReport();
+        return true;
+    }
     else if (input == F("b"))
     {
         // go back to main menu
@@ -37,7 +37,7 @@ void SyncManager::begin()
 
 void SyncManager::loop()
 {
-  timeProfiler.start("syncManagerLoop", TimeUnit::MICROSECONDS);
+  timeProfiler.start(PROFILER_ID("syncManagerLoop"), TimeUnit::MICROSECONDS);
 
   uint32_t now = millis();
   if (now - lastHeartbeat >= HEARTBEAT_INTERVAL)
@@ -89,7 +89,7 @@ void SyncManager::loop()
     }
   }
 
-  timeProfiler.stop("syncManagerLoop");
+  timeProfiler.stop(PROFILER_ID("syncManagerLoop"));
 }
 
 const std::map<std::string, DiscoveredDevice> &
@@ -988,7 +988,8 @@ void SyncManager::processEffectState(fullPacket *fp)
   if (currentGroup.isMaster || currentGroup.groupId == 0)
     return;
 
-  if (fp->p.len < 1 + sizeof(EffectSyncState))
+  // A leader on other firmware sends another layout
+  if (fp->p.len != 1 + sizeof(EffectSyncState))
     return;
 
   EffectSyncState newState;
@@ -71,9 +71,28 @@ void LEDConfig::print()
                 interiorEnabled ? "ENABLED" : "DISABLED",
                 interiorLedCount, 0, // interiorPin,
                 interiorFlipped ? "YES" : "NO");
+  Serial.printf("LED buffers: %s internal, %s PSRAM\n",
+                formatBytes(getArenaBytes(ArenaPlacement::INTERNAL)).c_str(),
+                formatBytes(getArenaBytes(ArenaPlacement::PSRAM)).c_str());
   Serial.println();
 }
 
+size_t LEDConfig::getArenaBytes(ArenaPlacement placement) const
+{
+  size_t bytes = placement == ArenaPlacement::INTERNAL ? LED_ARENA_EFFECT_BYTES : 0;
+
+  if (headlightsEnabled)
+    bytes += LEDArena::stripBytes(headlightLedCount, placement);
+  if (taillightsEnabled)
+    bytes += LEDArena::stripBytes(taillightLedCount, placement);
+  if (underglowEnabled)
+    bytes += LEDArena::stripBytes(underglowLedCount, placement);
+  if (interiorEnabled)
+    bytes += LEDArena::stripBytes(interiorLedCount, placement);
+
+  return bytes;
+}
+
 LEDConfig ledConfig;
 
 void restart()
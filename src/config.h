@@ -3,6 +3,7 @@
 #include <Arduino.h>
 
 #include "IO/GPIO.h"
+#include "IO/LED/LEDArena.h"
 
 #include <WiFi.h>
 #include <esp_wifi.h>
@@ -56,6 +57,9 @@ struct LEDConfig
 
   LEDConfig();
   void print();
+
+  // LEDArena bytes the enabled strips need in a placement
+  size_t getArenaBytes(ArenaPlacement placement) const;
 };
 
 extern Preferences preferences;
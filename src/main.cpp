@@ -6,6 +6,7 @@
 #include "IO/GPIO.h"
 #include "IO/Wireless.h"
 #include "Application.h"
+#include "IO/LED/LEDStripManager.h"
 #include "SerialMenu.h"
 #include "IO/StatusLed.h"
 #include "IO/Battery.h"
@@ -14,6 +15,7 @@
 #endif
 #include "IO/ScreenManager.h"
 #include "IO/TimeProfiler.h"
+#include "IO/TraceRecorder.h"
 
 #include "Screens/StartUp.h"
 #include "Screens/Home.h"
@@ -139,22 +141,23 @@ unsigned long lastDraw = 0;
 void loop()
 {
   unsigned long currentTime = millis();
-  timeProfiler.start("mainLoop", TimeUnit::MICROSECONDS);
-  timeProfiler.increment("mainLoopFps");
+  timeProfiler.start(PROFILER_ID("mainLoop"), TimeUnit::MICROSECONDS);
+  timeProfiler.increment(PROFILER_ID("mainLoopFps"));
 
   wireless.loop(); // does nothing
 
   if (millis() - batteryLoopMs > 1000)
   {
     batteryLoopMs = millis();
-    timeProfiler.start("batteryUpdate", TimeUnit::MICROSECONDS);
+    timeProfiler.start(PROFILER_ID("batteryUpdate"), TimeUnit::MICROSECONDS);
     batteryUpdate(); // ~130 us
-    timeProfiler.stop("batteryUpdate");
+    timeProfiler.stop(PROFILER_ID("batteryUpdate"));
   }
 
-  if (millis() - lastApp > (10))
+  // Effects are updated and a new frame is published once per app loop
+  if (currentTime - lastApp >= 1000 / LED_UPDATE_FPS)
   {
-    lastApp = millis();
+    lastApp = currentTime;
     app->loop(); // ~2600 us
   }
 
@@ -162,12 +165,12 @@ void loop()
   {
     lastDraw = millis();
 
-    timeProfiler.start("btnUpdate", TimeUnit::MICROSECONDS);
+    timeProfiler.start(PROFILER_ID("btnUpdate"), TimeUnit::MICROSECONDS);
     BtnBoot.Update();
     BtnPrev.Update();
     BtnSel.Update();
     BtnNext.Update();
-    timeProfiler.stop("btnUpdate");
+    timeProfiler.stop(PROFILER_ID("btnUpdate"));
 
     app->btnLoop();
 
@@ -175,7 +178,9 @@ void loop()
 #ifdef ENABLE_DISPLAY
     if (deviceInfo.oledEnabled)
     {
+      traceRecorder.beginEvent("display.display");
       display.display(); //  ~22000 us
+      traceRecorder.endEvent("display.display");
     }
 #endif
   }
@@ -186,5 +191,5 @@ void loop()
     processMenuInput(input); // idk probably fuck all
   }
 
-  timeProfiler.stop("mainLoop"); // < 100 us avg
+  timeProfiler.stop(PROFILER_ID("mainLoop")); // < 100 us avg
 }
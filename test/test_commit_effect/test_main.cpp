@@ -0,0 +1,84 @@
+// test_main.cpp (native CommitEffect tests)
+//
+// Checks that commits run all the way out to the edges when more of them
+// would be on the strip than the effect has room for: a commit every frame,
+// slow enough and with a long enough trail that the oldest ones are still
+// on the strip when the pool is full.
+//
+//   pio test -e native -f test_commit_effect
+
+#include <Arduino.h>
+#include <unity.h>
+#include <string>
+
+#include "IO/LED/LEDStrip.h"
+#include "IO/LED/Effects/CommitEffect.h"
+
+static const uint32_t FRAME_US = 10000;
+
+static bool isLit(const CRGB &led) { return led.r || led.g || led.b; }
+
+// Runs the effect for frames and returns the first frame both edges are
+// lit, 0 if they never are
+static uint16_t framesToEdges(uint16_t numLEDs, uint32_t speed, uint16_t trail, uint32_t interval, uint16_t frames)
+{
+  nativeSetMicros(1000000);
+  LEDEffect::setFrameClock(nullptr);
+
+  LEDStrip *strip = new LEDStrip("Commit", numLEDs, 1);
+  strip->setActive(true);
+  CommitEffect *commit = new CommitEffect(5, false);
+  commit->commitSpeed = speed;
+  commit->trailLength = trail;
+  commit->commitInterval = interval;
+  strip->addEffect(commit);
+  commit->setActive(true);
+
+  uint16_t reached = 0;
+  for (uint16_t frame = 1; frame <= frames && reached == 0; frame++)
+  {
+    nativeAdvanceMicros(FRAME_US);
+    LEDEffect::updateAll();
+    strip->renderEffects();
+
+    const CRGB *leds = strip->getLastFrame();
+    if (isLit(leds[0]) && isLit(leds[numLEDs - 1]))
+      reached = frame;
+  }
+
+  delete commit;
+  delete strip;
+  return reached;
+}
+
+// A commit every frame at 1 LED per frame with a 65 LED trail lives for
+// over 200 frames on 300 LEDs, far more commits than the pool holds. The
+// first heads reach the edges after 150 frames.
+static void test_full_pool_reaches_edges()
+{
+  uint16_t reached = framesToEdges(300, 100000, 65000, 0, 400);
+  TEST_ASSERT_TRUE_MESSAGE(reached > 0, "commits were cut off before they reached the edges");
+  TEST_ASSERT_TRUE_MESSAGE(reached <= 152, ("edges reached late, frame " + std::to_string(reached)).c_str());
+}
+
+// The default settings never fill the pool
+static void test_defaults_reach_edges()
+{
+  uint16_t reached = framesToEdges(300, 20000, 15000, 1200, 1000);
+  TEST_ASSERT_TRUE_MESSAGE(reached > 0, "commits never reached the edges");
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+  // Strip construction logs are noise here
+  Serial.setOutput(nullptr);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_full_pool_reaches_edges);
+  RUN_TEST(test_defaults_reach_edges);
+  return UNITY_END();
+}
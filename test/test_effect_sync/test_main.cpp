@@ -0,0 +1,113 @@
+// test_main.cpp (native effect sync tests)
+//
+// A follower car turns effects on and off with setSyncData() instead of
+// setActive(). Checks that every synced effect then renders, and stops
+// again when the leader turns it off.
+//
+//   pio test -e native -f test_effect_sync
+
+#include <Arduino.h>
+#include <unity.h>
+#include <functional>
+#include <string>
+
+#include "IO/LED/LEDStrip.h"
+#include "IO/LED/Effects/RGBEffect.h"
+#include "IO/LED/Effects/NightRiderEffect.h"
+#include "IO/LED/Effects/PoliceEffect.h"
+#include "IO/LED/Effects/SolidColorEffect.h"
+#include "IO/LED/Effects/ColorFadeEffect.h"
+#include "IO/LED/Effects/CommitEffect.h"
+#include "IO/LED/Effects/ServiceLightsEffect.h"
+
+static const uint16_t NUM_LEDS = 60;
+static const uint32_t FRAME_US = 10000;
+static const uint16_t FRAMES = 200;
+
+// Sets the effect's active flag through its sync data, as
+// Application::handleSyncedEffects() does
+template <typename Effect>
+static void syncActive(Effect *effect, bool active)
+{
+  auto syncData = effect->getSyncData();
+  syncData.active = active;
+  effect->setSyncData(syncData);
+}
+
+// Frames out of FRAMES with any pixel lit
+static uint16_t litFrames(LEDStrip *strip)
+{
+  uint16_t lit = 0;
+  for (uint16_t frame = 0; frame < FRAMES; frame++)
+  {
+    nativeAdvanceMicros(FRAME_US);
+    LEDEffect::updateAll();
+    strip->renderEffects();
+
+    const CRGB *leds = strip->getLastFrame();
+    for (uint16_t i = 0; i < NUM_LEDS; i++)
+    {
+      if (leds[i].r || leds[i].g || leds[i].b)
+      {
+        lit++;
+        break;
+      }
+    }
+  }
+  return lit;
+}
+
+template <typename Effect>
+static void checkSynced(const char *name)
+{
+  nativeSetMicros(1000000);
+  LEDEffect::setFrameClock(nullptr);
+
+  LEDStrip *strip = new LEDStrip(name, NUM_LEDS, 1);
+  strip->setActive(true);
+  Effect *effect = new Effect(5, false);
+  strip->addEffect(effect);
+
+  syncActive(effect, true);
+  bool live = effect->isLive();
+  uint16_t litOn = litFrames(strip);
+
+  syncActive(effect, false);
+  uint16_t litOff = litFrames(strip);
+
+  delete effect;
+  delete strip;
+
+  std::string prefix = std::string(name) + ": ";
+  TEST_ASSERT_TRUE_MESSAGE(live, (prefix + "not live after setSyncData").c_str());
+  TEST_ASSERT_TRUE_MESSAGE(litOn > 0, (prefix + "drew nothing after setSyncData").c_str());
+  TEST_ASSERT_TRUE_MESSAGE(litOff == 0, (prefix + "still drawing after setSyncData turned it off").c_str());
+}
+
+static void test_rgb() { checkSynced<RGBEffect>("RGB"); }
+static void test_nightrider() { checkSynced<NightRiderEffect>("NightRider"); }
+static void test_police() { checkSynced<PoliceEffect>("Police"); }
+static void test_solid_color() { checkSynced<SolidColorEffect>("SolidColor"); }
+static void test_color_fade() { checkSynced<ColorFadeEffect>("ColorFade"); }
+static void test_commit() { checkSynced<CommitEffect>("Commit"); }
+static void test_service_lights() { checkSynced<ServiceLightsEffect>("ServiceLights"); }
+
+void setUp() {}
+
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+  // Strip construction logs are noise here
+  Serial.setOutput(nullptr);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_rgb);
+  RUN_TEST(test_nightrider);
+  RUN_TEST(test_police);
+  RUN_TEST(test_solid_color);
+  RUN_TEST(test_color_fade);
+  RUN_TEST(test_commit);
+  RUN_TEST(test_service_lights);
+  return UNITY_END();
+}
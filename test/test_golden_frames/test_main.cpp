@@ -0,0 +1,557 @@
+// test_main.cpp (native golden frame tests)
+//
+// Runs every LED effect on its own strip against the virtual clock and
+// compares sampled output frames of that strip with the recorded golden files in
+// golden/. Channels may differ by GOLDEN_TOLERANCE, so fixed point or LUT
+// rewrites that round differently still pass while visible changes fail.
+//
+//   pio test -e native                      compare against golden/
+//   GOLDEN_UPDATE=1 pio test -e native      re-record golden/ (review the diff!)
+//   GOLDEN_TOLERANCE=0 pio test -e native   require exact output
+//
+// Golden file layout (little endian):
+//   "LEDG", version u8, numLEDs u16, samples u16, sampleEvery u16, frameUs u32
+//   then per sample, runs of (count u8, r u8, g u8, b u8) covering numLEDs
+
+#include <Arduino.h>
+#include <unity.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "IO/LED/LEDStrip.h"
+#include "IO/LED/LEDLayout.h"
+#include "IO/LED/LEDStripManager.h"
+#include "IO/LED/Effects/BrakeLightEffect.h"
+#include "IO/LED/Effects/IndicatorEffect.h"
+#include "IO/LED/Effects/ReverseLightEffect.h"
+#include "IO/LED/Effects/RGBEffect.h"
+#include "IO/LED/Effects/NightRiderEffect.h"
+#include "IO/LED/Effects/TaillightEffect.h"
+#include "IO/LED/Effects/HeadlightEffect.h"
+#include "IO/LED/Effects/PoliceEffect.h"
+#include "IO/LED/Effects/PulseWaveEffect.h"
+#include "IO/LED/Effects/AuroraEffect.h"
+#include "IO/LED/Effects/SolidColorEffect.h"
+#include "IO/LED/Effects/ColorFadeEffect.h"
+#include "IO/LED/Effects/CommitEffect.h"
+#include "IO/LED/Effects/ServiceLightsEffect.h"
+
+static const uint8_t GOLDEN_VERSION = 1;
+static const uint8_t GOLDEN_TOLERANCE = 2;
+
+// Same frame rate the app updates effects at
+static const uint32_t FRAME_US = 10000;
+static const uint16_t FRAMES = 400;
+static const uint16_t SAMPLE_EVERY = 16;
+
+static const uint16_t stripLengths[] = {50, 120, 300};
+
+typedef std::vector<LEDEffect *> EffectList;
+
+struct GoldenCase
+{
+  const char *name;
+  // Creates the effects for the case on strip and turns them on
+  std::function<EffectList(LEDStrip *)> setup;
+};
+
+static std::string goldenDir()
+{
+  std::string file = __FILE__;
+  return file.substr(0, file.find_last_of("/\\") + 1) + "golden/";
+}
+
+// Strips of other types a case puts its effect on as well. They render
+// before the recorded strip every frame and the runner deletes them.
+static std::vector<LEDStrip *> companionStrips;
+
+// === ENCODING ===
+static void put16(std::vector<uint8_t> &out, uint16_t value)
+{
+  out.push_back(value & 0xFF);
+  out.push_back(value >> 8);
+}
+
+static void put32(std::vector<uint8_t> &out, uint32_t value)
+{
+  put16(out, value & 0xFFFF);
+  put16(out, value >> 16);
+}
+
+static uint16_t get16(const uint8_t *in) { return in[0] | (in[1] << 8); }
+
+static uint32_t get32(const uint8_t *in) { return get16(in) | ((uint32_t)get16(in + 2) << 16); }
+
+static void encodeFrame(std::vector<uint8_t> &out, const CRGB *leds, uint16_t numLEDs)
+{
+  uint16_t i = 0;
+  while (i < numLEDs)
+  {
+    uint8_t run = 1;
+    while (i + run < numLEDs && run < 255 && leds[i + run] == leds[i])
+      run++;
+    out.push_back(run);
+    out.push_back(leds[i].r);
+    out.push_back(leds[i].g);
+    out.push_back(leds[i].b);
+    i += run;
+  }
+}
+
+// Returns false if the data runs out or a run overflows the frame
+static bool decodeFrame(const std::vector<uint8_t> &in, size_t &pos, std::vector<CRGB> &leds)
+{
+  size_t i = 0;
+  while (i < leds.size())
+  {
+    if (pos + 4 > in.size() || in[pos] == 0 || i + in[pos] > leds.size())
+      return false;
+    CRGB color(in[pos + 1], in[pos + 2], in[pos + 3]);
+    for (uint8_t n = 0; n < in[pos]; n++)
+      leds[i++] = color;
+    pos += 4;
+  }
+  return true;
+}
+
+static bool readFile(const std::string &path, std::vector<uint8_t> &data)
+{
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file)
+    return false;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    data.insert(data.end(), chunk, chunk + n);
+  fclose(file);
+  return true;
+}
+
+static bool writeFile(const std::string &path, const std::vector<uint8_t> &data)
+{
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+  return fclose(file) == 0 && ok;
+}
+
+static uint8_t tolerance()
+{
+  const char *value = getenv("GOLDEN_TOLERANCE");
+  return value ? atoi(value) : GOLDEN_TOLERANCE;
+}
+
+static bool updating()
+{
+  const char *value = getenv("GOLDEN_UPDATE");
+  return value && value[0] && value[0] != '0';
+}
+
+// === RUNNER ===
+// Renders one case and returns the encoded samples, header included
+static std::vector<uint8_t> renderCase(const GoldenCase &goldenCase, uint16_t numLEDs)
+{
+  // Every case starts from the same clock, frame counter and random state
+  nativeSetMicros(1000000);
+  LEDEffect::setFrameClock(nullptr);
+  randomSeed(12345);
+
+  LEDStrip *strip = new LEDStrip(goldenCase.name, numLEDs, 1);
+  strip->setActive(true);
+  EffectList effects = goldenCase.setup(strip);
+
+  std::vector<uint8_t> out = {'L', 'E', 'D', 'G', GOLDEN_VERSION};
+  put16(out, numLEDs);
+  put16(out, FRAMES / SAMPLE_EVERY);
+  put16(out, SAMPLE_EVERY);
+  put32(out, FRAME_US);
+
+  for (uint16_t frame = 1; frame <= FRAMES; frame++)
+  {
+    nativeAdvanceMicros(FRAME_US);
+    LEDEffect::updateAll();
+    for (LEDStrip *companion : companionStrips)
+      companion->renderEffects();
+    strip->renderEffects();
+    strip->draw();
+
+    if (frame % SAMPLE_EVERY == 0)
+      encodeFrame(out, strip->getFastLEDBuffer(), numLEDs);
+  }
+
+  for (auto effect : effects)
+    delete effect;
+  for (LEDStrip *companion : companionStrips)
+    delete companion;
+  companionStrips.clear();
+  delete strip;
+  return out;
+}
+
+static void checkCase(const GoldenCase &goldenCase)
+{
+  for (uint16_t numLEDs : stripLengths)
+  {
+    std::string path = goldenDir() + goldenCase.name + "_" + std::to_string(numLEDs) + ".bin";
+    std::vector<uint8_t> actual = renderCase(goldenCase, numLEDs);
+
+    if (updating())
+    {
+      TEST_ASSERT_TRUE_MESSAGE(writeFile(path, actual), ("could not write " + path).c_str());
+      continue;
+    }
+
+    std::vector<uint8_t> expected;
+    TEST_ASSERT_TRUE_MESSAGE(readFile(path, expected),
+                             ("missing " + path + ", record it with GOLDEN_UPDATE=1").c_str());
+
+    const size_t HEADER = 15;
+    TEST_ASSERT_TRUE_MESSAGE(expected.size() >= HEADER && memcmp(expected.data(), actual.data(), 5) == 0,
+                             ("bad header in " + path).c_str());
+    TEST_ASSERT_TRUE_MESSAGE(get16(&expected[5]) == numLEDs && get16(&expected[7]) == FRAMES / SAMPLE_EVERY &&
+                                 get16(&expected[9]) == SAMPLE_EVERY && get32(&expected[11]) == FRAME_US,
+                             ("recorded with other settings: " + path).c_str());
+
+    // Compare decoded pixels so the tolerance applies per channel
+    uint8_t maxDiff = tolerance();
+    size_t expectedPos = HEADER, actualPos = HEADER;
+    std::vector<CRGB> expectedLeds(numLEDs), actualLeds(numLEDs);
+    uint32_t badPixels = 0;
+    char firstBad[160] = "";
+
+    for (uint16_t sample = 0; sample < FRAMES / SAMPLE_EVERY; sample++)
+    {
+      TEST_ASSERT_TRUE_MESSAGE(decodeFrame(expected, expectedPos, expectedLeds), ("truncated " + path).c_str());
+      TEST_ASSERT_TRUE(decodeFrame(actual, actualPos, actualLeds));
+
+      for (uint16_t i = 0; i < numLEDs; i++)
+      {
+        const CRGB &e = expectedLeds[i];
+        const CRGB &a = actualLeds[i];
+        int diff = std::max({abs(e.r - a.r), abs(e.g - a.g), abs(e.b - a.b)});
+        if (diff <= maxDiff)
+          continue;
+
+        if (badPixels++ == 0)
+          snprintf(firstBad, sizeof(firstBad), "frame %u led %u: expected (%u,%u,%u) got (%u,%u,%u)",
+                   (sample + 1) * SAMPLE_EVERY, i, e.r, e.g, e.b, a.r, a.g, a.b);
+      }
+    }
+
+    if (badPixels > 0)
+    {
+      std::string message = std::string(goldenCase.name) + "_" + std::to_string(numLEDs) + ": " +
+                            std::to_string(badPixels) + " pixels off by more than " + std::to_string(maxDiff) +
+                            ", first at " + firstBad;
+      TEST_FAIL_MESSAGE(message.c_str());
+    }
+  }
+}
+
+// Lays the strip up the left side, across the front and down the right,
+// like the underglow. The layout forgets it when the strip is deleted.
+static void placeAroundCar(LEDStrip *strip)
+{
+  LEDSegment *segment = strip->getMainSegment();
+  uint16_t numLEDs = strip->getNumLEDs();
+  uint16_t side = numLEDs / 3;
+  ledLayout.place(segment, 0, side, layoutPoint(-1.0f, -0.9f), layoutPoint(-1.0f, 0.9f));
+  ledLayout.place(segment, side, numLEDs - 2 * side, layoutPoint(-0.9f, 1.0f), layoutPoint(0.9f, 1.0f));
+  ledLayout.place(segment, numLEDs - side, side, layoutPoint(1.0f, 0.9f), layoutPoint(1.0f, -0.9f));
+  ledLayout.build();
+}
+
+// Splits the strip into two halves that run towards the middle and puts
+// effect on both. The strip deletes the segments.
+static void addToHalves(LEDStrip *strip, LEDEffect *effect)
+{
+  uint16_t half = strip->getNumLEDs() / 2;
+  LEDSegment *left = new LEDSegment(strip, "Left", 0, half);
+  LEDSegment *right = new LEDSegment(strip, "Right", half, strip->getNumLEDs() - half);
+  right->fliped = true;
+  left->addEffect(effect);
+  right->addEffect(effect);
+}
+
+// Gives strip a type, as LEDStripManager does
+static void setType(LEDStrip *strip, LEDStripType type)
+{
+  LEDStripConfig(type, strip, strip->getName());
+}
+
+// Adds a strip of type and the same length as strip
+static LEDStrip *addCompanion(LEDStrip *strip, LEDStripType type)
+{
+  LEDStrip *companion = new LEDStrip("Companion", strip->getNumLEDs(), 1);
+  setType(companion, type);
+  companion->setActive(true);
+  companionStrips.push_back(companion);
+  return companion;
+}
+
+// === CASES ===
+// Priorities match Application::setupEffects()
+static const GoldenCase goldenCases[] = {
+    {"taillight_startup", [](LEDStrip *strip)
+     {
+       TaillightEffect *taillight = new TaillightEffect(4, false);
+       strip->addEffect(taillight);
+       taillight->setStartup();
+       return EffectList{taillight};
+     }},
+    {"taillight_dim", [](LEDStrip *strip)
+     {
+       TaillightEffect *taillight = new TaillightEffect(4, false);
+       strip->addEffect(taillight);
+       taillight->setDim();
+       return EffectList{taillight};
+     }},
+    {"headlight_startup", [](LEDStrip *strip)
+     {
+       HeadlightEffect *headlight = new HeadlightEffect(4, false);
+       strip->addEffect(headlight);
+       headlight->setStartup();
+       return EffectList{headlight};
+     }},
+    {"headlight_split", [](LEDStrip *strip)
+     {
+       HeadlightEffect *headlight = new HeadlightEffect(4, false);
+       strip->addEffect(headlight);
+       headlight->setCarOn();
+       headlight->setSplit(true);
+       return EffectList{headlight};
+     }},
+    {"indicator_left", [](LEDStrip *strip)
+     {
+       IndicatorEffect *left = new IndicatorEffect(IndicatorEffect::LEFT, 10, true);
+       strip->addEffect(left);
+       left->setActive(true);
+       return EffectList{left};
+     }},
+    {"indicator_hazard", [](LEDStrip *strip)
+     {
+       IndicatorEffect *left = new IndicatorEffect(IndicatorEffect::LEFT, 10, true);
+       IndicatorEffect *right = new IndicatorEffect(IndicatorEffect::RIGHT, 10, true);
+       left->setOtherIndicator(right);
+       right->setOtherIndicator(left);
+       strip->addEffect(left);
+       strip->addEffect(right);
+       left->setActive(true);
+       right->setActive(true);
+       return EffectList{left, right};
+     }},
+    {"indicator_over_dim", [](LEDStrip *strip)
+     {
+       TaillightEffect *taillight = new TaillightEffect(4, false);
+       IndicatorEffect *right = new IndicatorEffect(IndicatorEffect::RIGHT, 10, true);
+       strip->addEffect(taillight);
+       strip->addEffect(right);
+       taillight->setDim();
+       right->setActive(true);
+       return EffectList{taillight, right};
+     }},
+    {"brake", [](LEDStrip *strip)
+     {
+       BrakeLightEffect *brake = new BrakeLightEffect(9, true);
+       strip->addEffect(brake);
+       brake->setActive(true);
+       return EffectList{brake};
+     }},
+    {"brake_over_dim", [](LEDStrip *strip)
+     {
+       TaillightEffect *taillight = new TaillightEffect(4, false);
+       BrakeLightEffect *brake = new BrakeLightEffect(9, true);
+       strip->addEffect(taillight);
+       strip->addEffect(brake);
+       taillight->setDim();
+       brake->setActive(true);
+       return EffectList{taillight, brake};
+     }},
+    {"reverse", [](LEDStrip *strip)
+     {
+       ReverseLightEffect *reverse = new ReverseLightEffect(8, true);
+       strip->addEffect(reverse);
+       reverse->setActive(true);
+       return EffectList{reverse};
+     }},
+    {"police_slow", [](LEDStrip *strip)
+     {
+       PoliceEffect *police = new PoliceEffect(4, false);
+       strip->addEffect(police);
+       police->setMode(PoliceMode::SLOW);
+       police->setActive(true);
+       return EffectList{police};
+     }},
+    {"police_fast", [](LEDStrip *strip)
+     {
+       PoliceEffect *police = new PoliceEffect(4, false);
+       strip->addEffect(police);
+       police->setMode(PoliceMode::FAST);
+       police->setActive(true);
+       return EffectList{police};
+     }},
+    {"service_slow", [](LEDStrip *strip)
+     {
+       ServiceLightsEffect *service = new ServiceLightsEffect(5, false);
+       strip->addEffect(service);
+       service->setMode(ServiceLightsMode::SLOW);
+       service->setActive(true);
+       return EffectList{service};
+     }},
+    {"service_scroll", [](LEDStrip *strip)
+     {
+       ServiceLightsEffect *service = new ServiceLightsEffect(5, false);
+       strip->addEffect(service);
+       service->setMode(ServiceLightsMode::SCROLL);
+       service->setActive(true);
+       return EffectList{service};
+     }},
+    {"service_scroll_underglow", [](LEDStrip *strip)
+     {
+       // The taillights draw first and scroll one way across, the underglow
+       // of the same length and symmetry scrolls out of the middle
+       LEDStrip *taillights = addCompanion(strip, LEDStripType::TAILLIGHT);
+       setType(strip, LEDStripType::UNDERGLOW);
+       taillights->getMainSegment()->setSymmetry(SegmentSymmetry::MIRROR_CENTER);
+       strip->getMainSegment()->setSymmetry(SegmentSymmetry::MIRROR_CENTER);
+       ServiceLightsEffect *service = new ServiceLightsEffect(5, false);
+       taillights->addEffect(service);
+       strip->addEffect(service);
+       service->setMode(ServiceLightsMode::SCROLL);
+       service->setActive(true);
+       return EffectList{service};
+     }},
+    {"commit", [](LEDStrip *strip)
+     {
+       CommitEffect *commit = new CommitEffect(5, false);
+       strip->addEffect(commit);
+       commit->setActive(true);
+       return EffectList{commit};
+     }},
+    {"nightrider", [](LEDStrip *strip)
+     {
+       NightRiderEffect *nightrider = new NightRiderEffect(5, false);
+       strip->addEffect(nightrider);
+       nightrider->setActive(true);
+       return EffectList{nightrider};
+     }},
+    {"nightrider_layout", [](LEDStrip *strip)
+     {
+       placeAroundCar(strip);
+       NightRiderEffect *nightrider = new NightRiderEffect(5, false);
+       strip->addEffect(nightrider);
+       nightrider->setActive(true);
+       return EffectList{nightrider};
+     }},
+    {"rgb", [](LEDStrip *strip)
+     {
+       RGBEffect *rgb = new RGBEffect(5, false);
+       strip->addEffect(rgb);
+       rgb->setActive(true);
+       return EffectList{rgb};
+     }},
+    {"aurora", [](LEDStrip *strip)
+     {
+       AuroraEffect *aurora = new AuroraEffect(5, false);
+       strip->addEffect(aurora);
+       aurora->setActive(true);
+       return EffectList{aurora};
+     }},
+    {"aurora_layout", [](LEDStrip *strip)
+     {
+       placeAroundCar(strip);
+       AuroraEffect *aurora = new AuroraEffect(5, false);
+       strip->addEffect(aurora);
+       aurora->setActive(true);
+       return EffectList{aurora};
+     }},
+    {"aurora_mirror", [](LEDStrip *strip)
+     {
+       strip->getMainSegment()->setSymmetry(SegmentSymmetry::MIRROR);
+       AuroraEffect *aurora = new AuroraEffect(5, false);
+       strip->addEffect(aurora);
+       aurora->setActive(true);
+       return EffectList{aurora};
+     }},
+    {"rgb_mirror_indicator", [](LEDStrip *strip)
+     {
+       strip->getMainSegment()->setSymmetry(SegmentSymmetry::MIRROR_CENTER);
+       RGBEffect *rgb = new RGBEffect(5, false);
+       IndicatorEffect *left = new IndicatorEffect(IndicatorEffect::LEFT, 10, true);
+       strip->addEffect(rgb);
+       strip->addEffect(left);
+       rgb->setActive(true);
+       left->setActive(true);
+       return EffectList{rgb, left};
+     }},
+    {"aurora_halves", [](LEDStrip *strip)
+     {
+       AuroraEffect *aurora = new AuroraEffect(5, false);
+       addToHalves(strip, aurora);
+       aurora->setActive(true);
+       return EffectList{aurora};
+     }},
+    {"rgb_halves_indicator", [](LEDStrip *strip)
+     {
+       RGBEffect *rgb = new RGBEffect(5, false);
+       IndicatorEffect *left = new IndicatorEffect(IndicatorEffect::LEFT, 10, true);
+       addToHalves(strip, rgb);
+       strip->getSegment("Left")->addEffect(left);
+       rgb->setActive(true);
+       left->setActive(true);
+       return EffectList{rgb, left};
+     }},
+    {"pulsewave", [](LEDStrip *strip)
+     {
+       PulseWaveEffect *pulseWave = new PulseWaveEffect(5, false);
+       strip->addEffect(pulseWave);
+       pulseWave->setActive(true);
+       return EffectList{pulseWave};
+     }},
+    {"pulsewave_layout", [](LEDStrip *strip)
+     {
+       placeAroundCar(strip);
+       PulseWaveEffect *pulseWave = new PulseWaveEffect(5, false);
+       strip->addEffect(pulseWave);
+       pulseWave->setActive(true);
+       return EffectList{pulseWave};
+     }},
+    {"colorfade", [](LEDStrip *strip)
+     {
+       ColorFadeEffect *colorFade = new ColorFadeEffect(5, false);
+       strip->addEffect(colorFade);
+       colorFade->setActive(true);
+       return EffectList{colorFade};
+     }},
+    {"solid", [](LEDStrip *strip)
+     {
+       SolidColorEffect *solid = new SolidColorEffect(5, false);
+       strip->addEffect(solid);
+       solid->setActive(true);
+       return EffectList{solid};
+     }},
+};
+
+static const GoldenCase *currentCase = nullptr;
+
+static void test_golden_case() { checkCase(*currentCase); }
+
+void setUp() {}
+
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+  // Strip construction logs are noise here
+  Serial.setOutput(nullptr);
+
+  UNITY_BEGIN();
+  for (const GoldenCase &goldenCase : goldenCases)
+  {
+    currentCase = &goldenCase;
+    UnityDefaultTestRun(test_golden_case, goldenCase.name, __LINE__);
+  }
+  return UNITY_END();
+}
@@ -0,0 +1,112 @@
+// test_main.cpp (native RGBEffect tests)
+//
+// Checks the mirrored fixed point gradient of RGBEffect against the float
+// reference it replaced: every pixel computes its hue from |i - mid| and
+// converts it with Color::hsv2rgb().
+//
+//   pio test -e native -f test_rgb_effect
+
+#include <Arduino.h>
+#include <unity.h>
+#include <string>
+
+#include "IO/LED/LEDStrip.h"
+#include "IO/LED/Effects/RGBEffect.h"
+
+// hsv2rgb16 is within 1 of hsv2rgb, the fixed point hue step adds at most 1
+static const int TOLERANCE = 2;
+
+static const uint16_t stripLengths[] = {1, 2, 3, 4, 49, 50, 120, 300, 1024};
+
+static const uint32_t FRAME_US = 10000;
+
+static Color referencePixel(uint16_t i, uint16_t num, float hueCenter, float hueEdge)
+{
+  uint16_t mid = num / 2;
+  float normDist = (mid > 0) ? fabs(static_cast<int>(i) - static_cast<int>(mid)) / static_cast<float>(mid) : 0.0f;
+
+  float diff = hueEdge - hueCenter;
+  if (diff < 0)
+    diff += 360.0f;
+
+  float hue = fmod(hueCenter - diff * normDist, 360.0f);
+  if (hue < 0)
+    hue += 360.0f;
+
+  return Color::hsv2rgb(hue, 1.0f, 1.0f);
+}
+
+// Runs the effect for frames and compares every frame with the reference
+static void checkGradient(float baseHueCenter, float baseHueEdge, float speed, uint16_t frames)
+{
+  for (uint16_t num : stripLengths)
+  {
+    nativeSetMicros(1000000);
+    LEDEffect::setFrameClock(nullptr);
+
+    LEDStrip *strip = new LEDStrip("RGB", num, 1);
+    strip->setActive(true);
+    RGBEffect *rgb = new RGBEffect(5, false);
+    rgb->baseHueCenter = baseHueCenter;
+    rgb->baseHueEdge = baseHueEdge;
+    rgb->speed = speed;
+    strip->addEffect(rgb);
+    rgb->setActive(true);
+
+    for (uint16_t frame = 0; frame < frames; frame++)
+    {
+      nativeAdvanceMicros(FRAME_US);
+      LEDEffect::updateAll();
+      strip->renderEffects();
+
+      RGBSyncData state = rgb->getSyncData();
+      const CRGB *actual = strip->getLastFrame();
+
+      for (uint16_t i = 0; i < num; i++)
+      {
+        Color expected = referencePixel(i, num, state.hueCenter, state.hueEdge);
+        int diff = std::max({abs(expected.r - actual[i].r), abs(expected.g - actual[i].g), abs(expected.b - actual[i].b)});
+        if (diff > TOLERANCE)
+        {
+          std::string message = "length " + std::to_string(num) + " frame " + std::to_string(frame) + " led " +
+                                std::to_string(i) + ": expected (" + std::to_string(expected.r) + "," +
+                                std::to_string(expected.g) + "," + std::to_string(expected.b) + ") got (" +
+                                std::to_string(actual[i].r) + "," + std::to_string(actual[i].g) + "," +
+                                std::to_string(actual[i].b) + ")";
+          delete rgb;
+          delete strip;
+          TEST_FAIL_MESSAGE(message.c_str());
+        }
+      }
+    }
+
+    delete rgb;
+    delete strip;
+  }
+}
+
+static void test_default_gradient() { checkGradient(1.0f, 270.0f, 180.0f, 250); }
+
+// Edge hue below the center hue, the difference wraps through 360
+static void test_wrapped_gradient() { checkGradient(300.0f, 40.0f, 45.0f, 250); }
+
+static void test_single_hue() { checkGradient(120.0f, 120.0f, 90.0f, 50); }
+
+static void test_static_gradient() { checkGradient(10.0f, 350.0f, 0.0f, 2); }
+
+void setUp() {}
+
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+  // Strip construction logs are noise here
+  Serial.setOutput(nullptr);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_default_gradient);
+  RUN_TEST(test_wrapped_gradient);
+  RUN_TEST(test_single_hue);
+  RUN_TEST(test_static_gradient);
+  return UNITY_END();
+}